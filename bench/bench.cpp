@@ -0,0 +1,480 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <yuJson/json.hpp>
+#include <yuJson/parser_context.hpp>
+
+#include "corpus.hpp"
+
+/*
+* yujson_bench [--seed N] [--scale F] [--min-time SEC] [--out FILE] [file.json ...]
+* Runs parse / print / lookup / iterate over the generated corpora and any given files,
+* and writes the results as a JSON document.
+*/
+
+namespace {
+
+std::atomic<uint64_t> g_alloc_count{ 0 };
+std::atomic<uint64_t> g_alloc_bytes{ 0 };
+
+struct AllocSnapshot {
+    uint64_t count;
+    uint64_t bytes;
+};
+
+AllocSnapshot Allocs() {
+    return AllocSnapshot{ g_alloc_count.load(std::memory_order_relaxed), g_alloc_bytes.load(std::memory_order_relaxed) };
+}
+
+} // namespace
+
+// Kept out of line: inlined into std::allocator, GCC pairs the inner malloc / free with
+// the operator new / delete calls and reports them as mismatched (-Wmismatched-new-delete).
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+BENCH_NOINLINE void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using Json = yuJson::Json;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    uint64_t seed = 42;
+    double scale = 1.0;
+    double min_time = 1.0;
+    std::string out;
+    std::vector<std::string> files;
+};
+
+struct Result {
+    uint64_t iterations = 0;
+    double seconds = 0;
+    uint64_t bytes = 0;       // bytes processed per iteration, 0 when throughput is counted in items
+    uint64_t items = 0;       // lookups or nodes per iteration, 0 for whole documents
+    AllocSnapshot allocs{ 0, 0 };
+};
+
+// Runs op until min_time has passed, op returns the number of bytes it processed.
+template <typename Op>
+Result Measure(double min_time, Op op) {
+    Result result;
+    auto alloc_begin = Allocs();
+    auto begin = Clock::now();
+    do {
+        result.bytes = op();
+        ++result.iterations;
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    } while (result.seconds < min_time);
+    auto alloc_end = Allocs();
+    result.allocs.count = alloc_end.count - alloc_begin.count;
+    result.allocs.bytes = alloc_end.bytes - alloc_begin.bytes;
+    return result;
+}
+
+void CollectObjects(Json& json, std::vector<std::pair<Json*, std::string>>* keys, uint64_t* nodes) {
+    ++*nodes;
+    if (json.IsObject()) {
+        for (auto& it : json) {
+            keys->emplace_back(&json, it.key());
+            CollectObjects(it.value(), keys, nodes);
+        }
+    }
+    else if (json.IsArray()) {
+        for (auto& it : json) {
+            CollectObjects(it.value(), keys, nodes);
+        }
+    }
+}
+
+void CollectFrozen(yuJson::FrozenValue value, std::vector<std::pair<yuJson::FrozenValue, yuJson::Key>>* keys) {
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value.IsObject()) {
+            keys->emplace_back(value, yuJson::Key(value.KeyAt(i)));
+        }
+        CollectFrozen(value[i], keys);
+    }
+}
+
+// The largest array whose elements are all objects, nullptr when there is none.
+Json* FindRecords(Json& json) {
+    Json* best = nullptr;
+    auto all = yuJson::JsonPath::Compile("$..*");
+    for (auto node : json.Select(all)) {
+        if (!node->IsArray() || node->size() == 0 || (best && node->size() <= best->size())) {
+            continue;
+        }
+        bool records = true;
+        for (auto& element : node->Elements()) {
+            records = records && element.IsObject();
+        }
+        if (records) {
+            best = node;
+        }
+    }
+    return best;
+}
+
+uint64_t Iterate(Json& json) {
+    uint64_t nodes = 1;
+    if (json.IsArray() || json.IsObject()) {
+        for (auto& it : json) {
+            nodes += Iterate(it.value());
+        }
+    }
+    return nodes;
+}
+
+Json Report(const std::string& corpus, const char* benchmark, const Result& result) {
+    double iterations = static_cast<double>(result.iterations);
+    double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+    Json report = Json::Object();
+    report["corpus"] = corpus;
+    report["benchmark"] = benchmark;
+    report["iterations"] = iterations;
+    report["seconds"] = result.seconds;
+    if (result.bytes) {
+        report["bytes"] = static_cast<double>(result.bytes);
+        report["mb_per_s"] = result.bytes * iterations / seconds / (1024 * 1024);
+    }
+    report["docs_per_s"] = iterations / seconds;
+    if (result.items) {
+        report["items"] = static_cast<double>(result.items);
+        report["items_per_s"] = result.items * iterations / seconds;
+    }
+    report["allocs_per_doc"] = result.allocs.count / iterations;
+    report["alloc_bytes_per_doc"] = result.allocs.bytes / iterations;
+    return report;
+}
+
+void BenchCorpus(const std::string& name, const std::string& text, const Options& options, Json* results) {
+    std::cerr << "bench " << name << " (" << text.size() << " bytes)" << std::endl;
+
+    auto doc = Json::Parse(text);
+    if (!doc.IsValid()) {
+        std::cerr << "  skipped, invalid json" << std::endl;
+        return;
+    }
+
+    auto parse = Measure(options.min_time, [&]() {
+        auto json = Json::Parse(text);
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse", parse));
+
+    // reading runs on the reader thread, the stream stands in for a file or a pipe
+    auto parse_pipelined = Measure(options.min_time, [&]() {
+        std::istringstream stream(text);
+        yuJson::PipelinedReader reader(stream);
+        auto json = Json::Parse(&reader);
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_pipelined", parse_pipelined));
+
+    yuJson::MonotonicResource pool;
+    auto parse_monotonic = Measure(options.min_time, [&]() {
+        {
+            yuJson::MemoryResourceScope scope(&pool);
+            auto json = Json::Parse(text);
+        }
+        pool.Release();
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_monotonic", parse_monotonic));
+
+    yuJson::ParserContext context(yuJson::ParseOptions{}, true);
+    auto parse_context = Measure(options.min_time, [&]() {
+        {
+            auto json = context.Parse(text);
+        }
+        context.Reset();
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_context", parse_context));
+
+    yuJson::ParseOptions utf8_options;
+    utf8_options.validate_utf8 = true;
+    auto parse_utf8 = Measure(options.min_time, [&]() {
+        auto json = Json::Parse(text, utf8_options);
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_validate_utf8", parse_utf8));
+
+    yuJson::ParseOptions lazy_options;
+    lazy_options.lazy_numbers = true;
+    auto parse_lazy = Measure(options.min_time, [&]() {
+        auto json = Json::Parse(text, lazy_options);
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_lazy_numbers", parse_lazy));
+
+    auto lazy_doc = Json::Parse(text, lazy_options);
+    auto print_lazy = Measure(options.min_time, [&]() {
+        return uint64_t{ lazy_doc.Print(false).size() };
+    });
+    results->push_back(Report(name, "print_lazy_numbers", print_lazy));
+
+    yuJson::ParseOptions lazy_string_options;
+    lazy_string_options.lazy_strings = true;
+    auto parse_lazy_strings = Measure(options.min_time, [&]() {
+        auto json = Json::Parse(text, lazy_string_options);
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "parse_lazy_strings", parse_lazy_strings));
+
+    auto lazy_string_doc = Json::Parse(text, lazy_string_options);
+    auto print_lazy_strings = Measure(options.min_time, [&]() {
+        return uint64_t{ lazy_string_doc.Print(false).size() };
+    });
+    results->push_back(Report(name, "print_lazy_strings", print_lazy_strings));
+
+    auto print = Measure(options.min_time, [&]() {
+        return uint64_t{ doc.Print(false).size() };
+    });
+    results->push_back(Report(name, "print", print));
+
+    auto print_format = Measure(options.min_time, [&]() {
+        return uint64_t{ doc.Print(true).size() };
+    });
+    results->push_back(Report(name, "print_format", print_format));
+
+    std::vector<std::pair<Json*, std::string>> keys;
+    uint64_t nodes = 0;
+    CollectObjects(doc, &keys, &nodes);
+
+    auto lookup = Measure(options.min_time, [&]() {
+        uint64_t found = 0;
+        for (auto& it : keys) {
+            found += it.first->find(it.second) != it.first->end();
+        }
+        if (found != keys.size()) {
+            std::abort();
+        }
+        return uint64_t{ 0 };
+    });
+    lookup.items = keys.size();
+    results->push_back(Report(name, "lookup", lookup));
+
+    auto frozen = doc.Freeze();
+    std::vector<std::pair<yuJson::FrozenValue, yuJson::Key>> frozen_keys;
+    CollectFrozen(frozen.Root(), &frozen_keys);
+    auto lookup_frozen = Measure(options.min_time, [&]() {
+        uint64_t found = 0;
+        for (auto& it : frozen_keys) {
+            found += it.first.Find(it.second).IsValid();
+        }
+        if (found != frozen_keys.size()) {
+            std::abort();
+        }
+        return uint64_t{ 0 };
+    });
+    lookup_frozen.items = frozen_keys.size();
+    results->push_back(Report(name, "lookup_frozen", lookup_frozen));
+
+    auto recursive_path = yuJson::JsonPath::Compile("$..*");
+    std::vector<Json*> matches;
+    auto select_recursive = Measure(options.min_time, [&]() {
+        matches.clear();
+        doc.Select(recursive_path, &matches);
+        return uint64_t{ 0 };
+    });
+    select_recursive.items = matches.size();
+    results->push_back(Report(name, "select_recursive", select_recursive));
+
+    auto filter_path = yuJson::JsonPath::Compile("$..[?(@ > 100 || @.id)]");
+    auto select_filter = Measure(options.min_time, [&]() {
+        matches.clear();
+        doc.Select(filter_path, &matches);
+        return uint64_t{ 0 };
+    });
+    select_filter.items = matches.size();
+    results->push_back(Report(name, "select_filter", select_filter));
+
+    // every value is visited, this measures the event stream against Parse
+    auto schema = yuJson::JsonSchema::Compile(R"({"type": ["object", "array"], "items": {"maxLength": 1000000}, "additionalProperties": {"minimum": -9000000000000000000}})");
+    auto validate_text = Measure(options.min_time, [&]() {
+        if (!schema.ValidateText(text)) {
+            std::abort();
+        }
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "validate_text", validate_text));
+
+    auto validate_tree = Measure(options.min_time, [&]() {
+        if (!doc.Validate(schema)) {
+            std::abort();
+        }
+        return uint64_t{ 0 };
+    });
+    validate_tree.items = nodes;
+    results->push_back(Report(name, "validate_tree", validate_tree));
+
+    // a redaction that rarely matches, so nearly all of the text is copied through
+    yuJson::StreamTransformer transformer;
+    transformer.Drop("/**/password");
+    transformer.Replace("/**/id_str", R"("")");
+    std::string transformed;
+    auto transform = Measure(options.min_time, [&]() {
+        transformed.clear();
+        if (!transformer.Transform(text, &transformed)) {
+            std::abort();
+        }
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "transform", transform));
+
+    std::string reformatted;
+    auto minify = Measure(options.min_time, [&]() {
+        reformatted.clear();
+        if (!yuJson::Minify(text, &reformatted)) {
+            std::abort();
+        }
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "minify", minify));
+
+    auto prettify = Measure(options.min_time, [&]() {
+        reformatted.clear();
+        if (!yuJson::Prettify(text, &reformatted)) {
+            std::abort();
+        }
+        return uint64_t{ text.size() };
+    });
+    results->push_back(Report(name, "prettify", prettify));
+
+    if (auto records = FindRecords(doc)) {
+        auto records_text = records->Print(false);
+        auto to_columns = Measure(options.min_time, [&]() {
+            if (!records->ToColumns().IsValid()) {
+                std::abort();
+            }
+            return uint64_t{ 0 };
+        });
+        to_columns.items = records->size();
+        results->push_back(Report(name, "to_columns", to_columns));
+
+        auto parse_columns = Measure(options.min_time, [&]() {
+            if (yuJson::ColumnarTable::Parse(records_text).Rows() != records->size()) {
+                std::abort();
+            }
+            return uint64_t{ records_text.size() };
+        });
+        results->push_back(Report(name, "parse_columns", parse_columns));
+    }
+
+    auto iterate = Measure(options.min_time, [&]() {
+        if (Iterate(doc) != nodes) {
+            std::abort();
+        }
+        return uint64_t{ 0 };
+    });
+    iterate.items = nodes;
+    results->push_back(Report(name, "iterate", iterate));
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--seed" && has_value) {
+            options->seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--scale" && has_value) {
+            options->scale = std::atof(argv[++i]);
+        }
+        else if (arg == "--min-time" && has_value) {
+            options->min_time = std::atof(argv[++i]);
+        }
+        else if (arg == "--out" && has_value) {
+            options->out = argv[++i];
+        }
+        else if (!arg.empty() && arg[0] != '-') {
+            options->files.push_back(arg);
+        }
+        else {
+            std::cerr << "usage: yujson_bench [--seed N] [--scale F] [--min-time SEC] [--out FILE] [file.json ...]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        return 1;
+    }
+
+    Json results = Json::Array();
+    BenchCorpus("twitter", corpus::Twitter(options.seed, options.scale), options, &results);
+    BenchCorpus("canada", corpus::Canada(options.seed, options.scale), options, &results);
+    BenchCorpus("citm_catalog", corpus::CitmCatalog(options.seed, options.scale), options, &results);
+    for (auto& file : options.files) {
+        std::ifstream in(file, std::ios::binary);
+        if (!in) {
+            std::cerr << "cannot open " << file << std::endl;
+            return 1;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        BenchCorpus(file, text.str(), options, &results);
+    }
+
+    Json report = Json::Object();
+    report["library"] = "yuJson";
+    report["seed"] = static_cast<double>(options.seed);
+    report["scale"] = options.scale;
+    report["min_time"] = options.min_time;
+    report["results"] = std::move(results);
+
+    auto output = report.Print(true);
+    if (options.out.empty()) {
+        std::cout << output << std::endl;
+    }
+    else {
+        std::ofstream out(options.out, std::ios::binary);
+        out << output << std::endl;
+    }
+    return 0;
+}
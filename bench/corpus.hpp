@@ -0,0 +1,203 @@
+#ifndef YUJSON_BENCH_CORPUS_HPP_
+#define YUJSON_BENCH_CORPUS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <cstdio>
+
+/*
+* Seeded generators that reproduce the shape of the usual JSON benchmark corpora.
+* The numbers come from splitmix64 mapped by hand, so a seed gives the same text with every standard library.
+* twitter:      string heavy objects, unicode escapes, deep user/entities records
+* canada:       GeoJSON polygon, almost only floats in small nested arrays
+* citm_catalog: wide objects keyed by numeric ids, many integers and short arrays
+* scale 1.0 gives roughly the size of the original files.
+*/
+namespace corpus {
+
+class Generator {
+public:
+    explicit Generator(uint64_t seed) : state_(seed) { }
+
+public:
+    uint64_t Next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // the modulo bias is far below what the corpora could show
+    int64_t Int(int64_t min, int64_t max) {
+        uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+        uint64_t offset = range == 0 ? Next() : Next() % range;
+        return static_cast<int64_t>(static_cast<uint64_t>(min) + offset);
+    }
+
+    // 53 random bits, uniform in [min, max)
+    double Float(double min, double max) {
+        return min + (max - min) * (static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+    bool Chance(double p) {
+        return Float(0, 1) < p;
+    }
+
+    std::string Word(size_t min_len, size_t max_len) {
+        static const char kLetters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+        std::string word;
+        auto len = Int(min_len, max_len);
+        for (int64_t i = 0; i < len; i++) {
+            word += kLetters[Int(0, sizeof(kLetters) - 2)];
+        }
+        return word;
+    }
+
+    // Quoted JSON string of words, with escapes and non-ASCII text mixed in.
+    std::string Text(size_t words) {
+        static const char* kExtras[] = {
+            "\\n", "\\\"", "\\/", "\\u3042\\u3044", "\\ud83d\\ude00", "\xe3\x81\x93\xe3\x82\x93", "\xc3\xa9t\xc3\xa9", "#tag", "@user"
+        };
+        std::string text = "\"";
+        for (size_t i = 0; i < words; i++) {
+            if (i) text += ' ';
+            if (Chance(0.15)) {
+                text += kExtras[Int(0, sizeof(kExtras) / sizeof(kExtras[0]) - 1)];
+            }
+            else {
+                text += Word(1, 9);
+            }
+        }
+        return text + "\"";
+    }
+
+private:
+    uint64_t state_;
+};
+
+inline std::string Quote(const std::string& str) {
+    return "\"" + str + "\"";
+}
+
+inline std::string Float(double d) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.15g", d);
+    std::string str = buf;
+    if (str.find_first_of(".e") == std::string::npos) {
+        str += ".0";
+    }
+    return str;
+}
+
+inline std::string Twitter(uint64_t seed, double scale) {
+    Generator gen(seed);
+    size_t count = static_cast<size_t>(380 * scale) + 1;
+    std::string json = "{\"statuses\": [";
+    for (size_t i = 0; i < count; i++) {
+        if (i) json += ", ";
+        auto id = std::to_string(gen.Int(500000000000000000, 505000000000000000));
+        auto user_id = std::to_string(gen.Int(1000000, 2000000000));
+        json += "{\"metadata\": {\"result_type\": \"recent\", \"iso_language_code\": \"ja\"}, ";
+        json += "\"created_at\": \"Sun Aug 31 00:29:15 +0000 2014\", ";
+        json += "\"id\": " + id + ", \"id_str\": " + Quote(id) + ", ";
+        json += "\"text\": " + gen.Text(gen.Int(4, 24)) + ", ";
+        json += "\"source\": \"<a href=\\\"https://mobile.twitter.com\\\" rel=\\\"nofollow\\\">Mobile Web</a>\", ";
+        json += "\"truncated\": false, \"in_reply_to_status_id\": null, \"in_reply_to_user_id\": null, ";
+        json += "\"user\": {\"id\": " + user_id + ", \"id_str\": " + Quote(user_id) + ", ";
+        json += "\"name\": " + gen.Text(2) + ", \"screen_name\": " + Quote(gen.Word(4, 15)) + ", ";
+        json += "\"location\": " + gen.Text(gen.Int(0, 3)) + ", \"description\": " + gen.Text(gen.Int(0, 30)) + ", ";
+        json += "\"url\": null, \"entities\": {\"description\": {\"urls\": []}}, \"protected\": false, ";
+        json += "\"followers_count\": " + std::to_string(gen.Int(0, 100000)) + ", ";
+        json += "\"friends_count\": " + std::to_string(gen.Int(0, 5000)) + ", ";
+        json += "\"listed_count\": " + std::to_string(gen.Int(0, 100)) + ", ";
+        json += "\"favourites_count\": " + std::to_string(gen.Int(0, 50000)) + ", ";
+        json += "\"utc_offset\": null, \"time_zone\": null, \"geo_enabled\": " + std::string(gen.Chance(0.3) ? "true" : "false") + ", ";
+        json += "\"verified\": false, \"statuses_count\": " + std::to_string(gen.Int(0, 100000)) + ", \"lang\": \"ja\", ";
+        json += "\"profile_background_color\": \"C0DEED\", \"profile_image_url\": \"http:\\/\\/pbs.twimg.com\\/profile_images\\/" + gen.Word(8, 20) + ".jpeg\", ";
+        json += "\"default_profile\": true, \"following\": false, \"notifications\": false}, ";
+        json += "\"geo\": null, \"coordinates\": null, \"place\": null, \"contributors\": null, ";
+        json += "\"retweet_count\": " + std::to_string(gen.Int(0, 1000)) + ", \"favorite_count\": " + std::to_string(gen.Int(0, 1000)) + ", ";
+        json += "\"entities\": {\"hashtags\": [";
+        auto tags = gen.Int(0, 3);
+        for (int64_t t = 0; t < tags; t++) {
+            if (t) json += ", ";
+            json += "{\"text\": " + Quote(gen.Word(3, 12)) + ", \"indices\": [" + std::to_string(gen.Int(0, 60)) + ", " + std::to_string(gen.Int(60, 140)) + "]}";
+        }
+        json += "], \"symbols\": [], \"urls\": [], \"user_mentions\": []}, ";
+        json += "\"favorited\": false, \"retweeted\": false, \"lang\": \"ja\"}";
+    }
+    json += "], \"search_metadata\": {\"completed_in\": 0.087, \"max_id\": 505874924095815700, ";
+    json += "\"query\": \"%E4%B8%80\", \"count\": " + std::to_string(count) + ", \"since_id\": 0}}";
+    return json;
+}
+
+inline std::string Canada(uint64_t seed, double scale) {
+    Generator gen(seed);
+    size_t rings = static_cast<size_t>(240 * scale) + 1;
+    std::string json = "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", ";
+    json += "\"properties\": {\"name\": \"Canada\"}, \"geometry\": {\"type\": \"Polygon\", \"coordinates\": [";
+    for (size_t r = 0; r < rings; r++) {
+        if (r) json += ", ";
+        json += '[';
+        auto points = gen.Int(16, 450);
+        double lon = gen.Float(-141.0, -52.0);
+        double lat = gen.Float(42.0, 83.0);
+        for (int64_t p = 0; p < points; p++) {
+            if (p) json += ", ";
+            lon += gen.Float(-0.05, 0.05);
+            lat += gen.Float(-0.05, 0.05);
+            json += '[' + Float(lon) + ", " + Float(lat) + ']';
+        }
+        json += ']';
+    }
+    json += "]}}]}";
+    return json;
+}
+
+inline std::string CitmCatalog(uint64_t seed, double scale) {
+    Generator gen(seed);
+    size_t events = static_cast<size_t>(600 * scale) + 1;
+    size_t performances = static_cast<size_t>(2400 * scale) + 1;
+    std::string json = "{\"areaNames\": {";
+    for (int i = 0; i < 17; i++) {
+        if (i) json += ", ";
+        json += Quote(std::to_string(205705993 + i)) + ": " + gen.Text(gen.Int(1, 3));
+    }
+    json += "}, \"audienceSubCategoryNames\": {\"337100890\": \"Abonn\xc3\xa9\"}, \"blockNames\": {}, \"events\": {";
+    for (size_t i = 0; i < events; i++) {
+        if (i) json += ", ";
+        auto id = std::to_string(138586341 + i * 7);
+        json += Quote(id) + ": {\"description\": null, \"id\": " + id + ", \"logo\": ";
+        json += gen.Chance(0.4) ? "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"" : "null";
+        json += ", \"name\": " + gen.Text(gen.Int(1, 5)) + ", \"subTitle\": null, \"subjectCode\": null, ";
+        json += "\"subTopicIds\": [337184269, 337184283], \"topicIds\": [324846099, 107888604]}";
+    }
+    json += "}, \"performances\": [";
+    for (size_t i = 0; i < performances; i++) {
+        if (i) json += ", ";
+        json += "{\"eventId\": " + std::to_string(138586341 + gen.Int(0, events) * 7) + ", ";
+        json += "\"id\": " + std::to_string(339887544 + i) + ", \"logo\": null, \"name\": null, \"prices\": [";
+        auto prices = gen.Int(1, 4);
+        for (int64_t p = 0; p < prices; p++) {
+            if (p) json += ", ";
+            json += "{\"amount\": " + std::to_string(gen.Int(10, 200) * 250) + ", ";
+            json += "\"audienceSubCategoryId\": 337100890, \"seatCategoryId\": " + std::to_string(338937295 + p) + "}";
+        }
+        json += "], \"seatCategories\": [";
+        for (int64_t p = 0; p < prices; p++) {
+            if (p) json += ", ";
+            json += "{\"areas\": [{\"areaId\": " + std::to_string(205705999 + p) + ", \"blockIds\": []}, ";
+            json += "{\"areaId\": " + std::to_string(205705998 + p) + ", \"blockIds\": []}], ";
+            json += "\"seatCategoryId\": " + std::to_string(338937295 + p) + "}";
+        }
+        json += "], \"seatMapImage\": null, \"start\": " + std::to_string(1372701600000 + gen.Int(0, 1000) * 86400000) + ", ";
+        json += "\"venueCode\": \"PLEYEL_PLEYEL\"}";
+    }
+    json += "], \"seatCategoryNames\": {\"338937295\": \"1\xc3\xa8re cat\xc3\xa9gorie\"}, \"subTopicNames\": {\"337184269\": \"Classique\"}, ";
+    json += "\"topicNames\": {\"107888604\": \"Musique\", \"324846099\": \"Genre\"}, \"venueNames\": {\"PLEYEL_PLEYEL\": \"Salle Pleyel\"}}";
+    return json;
+}
+
+} // namespace corpus
+
+#endif // YUJSON_BENCH_CORPUS_HPP_
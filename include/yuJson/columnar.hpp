@@ -0,0 +1,542 @@
+#ifndef YUJSON_COLUMNAR_HPP_
+#define YUJSON_COLUMNAR_HPP_
+
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <yuJson/value/value.hpp>
+#include <yuJson/compiler/lexer.hpp>
+
+namespace yuJson {
+
+enum class ColumnType {
+    kNull = 0,      // no row has a value yet
+    kBoolean,
+    kInt,
+    kFloat,
+    kString
+};
+
+/*
+* One field of a ColumnarTable, every vector of the column type has one entry per row.
+* Rows without a usable value hold 0 / an empty string and have their validity bit cleared.
+* The bitmap is LSB first like Arrow: row i is bit i % 8 of validity[i / 8].
+*/
+struct Column {
+    std::string name;
+    ColumnType type = ColumnType::kNull;
+    std::vector<uint8_t> booleans;
+    std::vector<int64_t> ints;
+    std::vector<double> floats;
+    std::vector<uint64_t> offsets{ 0 };     // row i is chars[offsets[i], offsets[i + 1])
+    std::string chars;
+    std::vector<uint8_t> validity;
+    size_t null_count = 0;
+    size_t mismatches = 0;                  // values of another type or arrays / objects, counted as null
+
+    bool IsValid(size_t row) const noexcept {
+        return (validity[row / 8] >> (row % 8)) & 1;
+    }
+
+    StringView StringAt(size_t row) const noexcept {
+        return StringView(chars.data() + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row]));
+    }
+};
+
+/*
+* An array of objects pivoted into one typed column per key, see Json::ToColumns and ColumnarTable::Parse.
+* Columns are in order of first appearance. A column takes the type of its first value,
+* integers are widened to doubles once a float shows up, other type changes count as null.
+* Rows that are not objects are all null.
+*/
+class ColumnarTable {
+public:
+    ColumnarTable() noexcept { }
+
+    // Reads the rows straight from the text, no Json is built. Malformed text gives an invalid table and sets error.
+    static ColumnarTable Parse(StringView json_text, compiler::ParseError* error = nullptr, size_t* error_offset = nullptr) {
+        ColumnarTable table;
+        compiler::Lexer lexer(std::string(json_text.data(), json_text.size()));
+        TextReader reader(&lexer, &table);
+        bool success = reader.Run();
+        if (error) {
+            *error = reader.Error();
+        }
+        if (error_offset) {
+            *error_offset = reader.ErrorOffset();
+        }
+        if (!success) {
+            return ColumnarTable();
+        }
+        return table;
+    }
+
+    // An invalid table unless array is an array.
+    static ColumnarTable Build(value::ValueInterface* array) {
+        ColumnarTable table;
+        if (!array || !array->IsArray()) {
+            return table;
+        }
+        table.valid_ = true;
+        for (auto& row : array->GetArray().GetVector()) {
+            if (row && row->IsObject()) {
+                for (auto& member : row->GetObject().GetMap()) {
+                    table.SetCell(StringView(member.first), ToCell(member.second.get()));
+                }
+            }
+            table.EndRow();
+        }
+        table.Finish();
+        return table;
+    }
+
+public:
+    bool IsValid() const noexcept {
+        return valid_;
+    }
+
+    size_t Rows() const noexcept {
+        return rows_;
+    }
+
+    const std::vector<Column>& Columns() const noexcept {
+        return columns_;
+    }
+
+    const Column* Find(StringView name) const noexcept {
+        for (auto& column : columns_) {
+            if (StringView(column.name) == name) {
+                return &column;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct Cell {
+        enum Kind { kNull, kBoolean, kInt, kFloat, kString, kContainer } kind = kNull;
+        bool boolean = false;
+        int64_t int_value = 0;
+        double float_value = 0;
+        StringView str;
+    };
+
+    static Cell ToCell(value::ValueInterface* value) {
+        Cell cell;
+        if (!value) {
+            return cell;
+        }
+        switch (value->Type()) {
+        case value::ValueType::kBoolean:
+            cell.kind = Cell::kBoolean;
+            cell.boolean = value->GetBoolean().Get();
+            break;
+        case value::ValueType::kNumberInt:
+            cell.kind = Cell::kInt;
+            cell.int_value = value->GetNumberInt().Get();
+            break;
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            cell.kind = Cell::kFloat;
+            cell.float_value = value->GetNumberFloat().Get();
+            break;
+#endif
+        case value::ValueType::kString: {
+            auto& str = value->GetString().Get();
+            cell.kind = Cell::kString;
+            cell.str = StringView(str.data(), str.size());
+            break;
+        }
+        case value::ValueType::kArray:
+        case value::ValueType::kObject:
+            cell.kind = Cell::kContainer;
+            break;
+        default:
+            break;
+        }
+        return cell;
+    }
+
+    // Rows of the same shape hit the column after the previous one, so the name scan rarely runs.
+    Column* FindColumn(StringView name) {
+        if (next_column_ < columns_.size() && StringView(columns_[next_column_].name) == name) {
+            return &columns_[next_column_++];
+        }
+        for (size_t i = 0; i < columns_.size(); i++) {
+            if (StringView(columns_[i].name) == name) {
+                next_column_ = i + 1;
+                return &columns_[i];
+            }
+        }
+        columns_.emplace_back();
+        auto& column = columns_.back();
+        column.name.assign(name.data(), name.size());
+        FillNulls(&column, rows_);
+        next_column_ = columns_.size();
+        return &column;
+    }
+
+    void SetCell(StringView name, const Cell& cell) {
+        auto column = FindColumn(name);
+        if (Size(*column) > rows_) {
+            // a repeated key, the last value wins like in an object
+            Truncate(column, rows_);
+        }
+        FillNulls(column, rows_);
+        if (cell.kind == Cell::kNull || cell.kind == Cell::kContainer) {
+            column->mismatches += cell.kind == Cell::kContainer;
+            PushNull(column);
+            return;
+        }
+        if (column->type == ColumnType::kNull) {
+            // the rows so far were all null, they get slots of the new type
+            size_t rows = Size(*column);
+            column->type = cell.kind == Cell::kBoolean ? ColumnType::kBoolean :
+                cell.kind == Cell::kInt ? ColumnType::kInt :
+                cell.kind == Cell::kFloat ? ColumnType::kFloat : ColumnType::kString;
+            for (size_t i = 0; i < rows; i++) {
+                PushSlot(column);
+            }
+        }
+        else if (column->type == ColumnType::kInt && cell.kind == Cell::kFloat) {
+            column->type = ColumnType::kFloat;
+            column->floats.assign(column->ints.begin(), column->ints.end());
+            column->ints.clear();
+            column->ints.shrink_to_fit();
+        }
+        switch (column->type) {
+        case ColumnType::kBoolean:
+            if (cell.kind != Cell::kBoolean) {
+                break;
+            }
+            column->booleans.push_back(cell.boolean);
+            SetValid(column);
+            return;
+        case ColumnType::kInt:
+            if (cell.kind != Cell::kInt) {
+                break;
+            }
+            column->ints.push_back(cell.int_value);
+            SetValid(column);
+            return;
+        case ColumnType::kFloat:
+            if (cell.kind != Cell::kInt && cell.kind != Cell::kFloat) {
+                break;
+            }
+            column->floats.push_back(cell.kind == Cell::kInt ? static_cast<double>(cell.int_value) : cell.float_value);
+            SetValid(column);
+            return;
+        case ColumnType::kString:
+            if (cell.kind != Cell::kString) {
+                break;
+            }
+            column->chars.append(cell.str.data(), cell.str.size());
+            column->offsets.push_back(column->chars.size());
+            SetValid(column);
+            return;
+        default:
+            break;
+        }
+        ++column->mismatches;
+        PushNull(column);
+    }
+
+    void EndRow() {
+        ++rows_;
+        next_column_ = 0;
+    }
+
+    // Pads the columns that the last rows did not mention.
+    void Finish() {
+        for (auto& column : columns_) {
+            FillNulls(&column, rows_);
+        }
+    }
+
+    static size_t Size(const Column& column) noexcept {
+        return column.offsets.size() - 1 + column.booleans.size() + column.ints.size() + column.floats.size()
+            + (column.type == ColumnType::kNull ? column.null_count : 0);
+    }
+
+    static void FillNulls(Column* column, size_t rows) {
+        while (Size(*column) < rows) {
+            PushNull(column);
+        }
+    }
+
+    // An empty entry in the vector of the column type.
+    static void PushSlot(Column* column) {
+        switch (column->type) {
+        case ColumnType::kBoolean: column->booleans.push_back(0); break;
+        case ColumnType::kInt: column->ints.push_back(0); break;
+        case ColumnType::kFloat: column->floats.push_back(0); break;
+        case ColumnType::kString: column->offsets.push_back(column->chars.size()); break;
+        default: break;
+        }
+    }
+
+    static void PushNull(Column* column) {
+        size_t row = Size(*column);
+        PushSlot(column);
+        ++column->null_count;
+        if (column->validity.size() <= row / 8) {
+            column->validity.push_back(0);
+        }
+    }
+
+    static void SetValid(Column* column) {
+        size_t row = Size(*column) - 1;
+        if (column->validity.size() <= row / 8) {
+            column->validity.push_back(0);
+        }
+        column->validity[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+    }
+
+    // Drops the rows from row on.
+    static void Truncate(Column* column, size_t row) {
+        size_t size = Size(*column);
+        for (size_t i = row; i < size; i++) {
+            if (!column->IsValid(i)) {
+                --column->null_count;
+            }
+        }
+        switch (column->type) {
+        case ColumnType::kBoolean: column->booleans.resize(row); break;
+        case ColumnType::kInt: column->ints.resize(row); break;
+        case ColumnType::kFloat: column->floats.resize(row); break;
+        case ColumnType::kString:
+            column->offsets.resize(row + 1);
+            column->chars.resize(column->offsets[row]);
+            break;
+        default: break;
+        }
+        column->validity.resize((row + 7) / 8);
+        if (row % 8) {
+            column->validity.back() &= static_cast<uint8_t>((1u << (row % 8)) - 1);
+        }
+    }
+
+    // Walks the tokens of an array of flat objects, nested values are skipped.
+    class TextReader {
+    public:
+        TextReader(compiler::Lexer* lexer, ColumnarTable* table) noexcept : lexer_(lexer), table_(table) { }
+
+    public:
+        bool Run() {
+            compiler::Token token;
+            if (!Next(&token)) {
+                return false;
+            }
+            if (token.type != compiler::TokenType::kLbrack) {
+                return Unexpected(token);
+            }
+            if (!Next(&token)) {
+                return false;
+            }
+            if (token.type != compiler::TokenType::kRbrack) {
+                while (true) {
+                    if (!ParseRow(&token)) {
+                        return false;
+                    }
+                    table_->EndRow();
+                    if (!Next(&token)) {
+                        return false;
+                    }
+                    if (token.type == compiler::TokenType::kRbrack) {
+                        break;
+                    }
+                    if (token.type != compiler::TokenType::kComma) {
+                        return Unexpected(token);
+                    }
+                    if (!Next(&token)) {
+                        return false;
+                    }
+                }
+            }
+            if (!Next(&token)) {
+                return false;
+            }
+            if (token.type != compiler::TokenType::kEof) {
+                return Fail(compiler::ParseError::kTrailingCharacters, token.offset);
+            }
+            table_->Finish();
+            table_->valid_ = true;
+            return true;
+        }
+
+        compiler::ParseError Error() const noexcept {
+            return error_;
+        }
+
+        size_t ErrorOffset() const noexcept {
+            return error_offset_;
+        }
+
+    private:
+        // token is the first token of the row.
+        bool ParseRow(compiler::Token* token) {
+            if (token->type != compiler::TokenType::kLcurly) {
+                // not an object, the whole row stays null
+                return SkipValue(token);
+            }
+            if (!Next(token)) {
+                return false;
+            }
+            if (token->type == compiler::TokenType::kRcurly) {
+                return true;
+            }
+            while (true) {
+                if (token->type != compiler::TokenType::kString) {
+                    return Unexpected(*token);
+                }
+                key_ = token->str;
+                if (!Next(token)) {
+                    return false;
+                }
+                if (token->type != compiler::TokenType::kColon) {
+                    return Unexpected(*token);
+                }
+                if (!Next(token)) {
+                    return false;
+                }
+                Cell cell;
+                if (!ToCell(token, &cell)) {
+                    return false;
+                }
+                table_->SetCell(StringView(key_), cell);
+                if (!Next(token)) {
+                    return false;
+                }
+                if (token->type == compiler::TokenType::kRcurly) {
+                    return true;
+                }
+                if (token->type != compiler::TokenType::kComma) {
+                    return Unexpected(*token);
+                }
+                if (!Next(token)) {
+                    return false;
+                }
+            }
+        }
+
+        bool ToCell(compiler::Token* token, Cell* cell) {
+            switch (token->type) {
+            case compiler::TokenType::kNull:
+                return true;
+            case compiler::TokenType::kTrue:
+            case compiler::TokenType::kFalse:
+                cell->kind = Cell::kBoolean;
+                cell->boolean = token->type == compiler::TokenType::kTrue;
+                return true;
+            case compiler::TokenType::kNumberInt: {
+                const char* begin = token->str.c_str();
+                char* end;
+                errno = 0;
+                auto num = std::strtoll(begin, &end, 10);
+                if (end != begin + token->str.size()) {
+                    return Fail(compiler::ParseError::kInvalidNumber, token->offset);
+                }
+                if (errno == ERANGE) {
+                    return Fail(compiler::ParseError::kNumberOutOfRange, token->offset);
+                }
+                cell->kind = Cell::kInt;
+                cell->int_value = static_cast<int64_t>(num);
+                return true;
+            }
+            case compiler::TokenType::kNumberFloat: {
+                const char* begin = token->str.c_str();
+                char* end;
+                errno = 0;
+                auto num = std::strtod(begin, &end);
+                if (end != begin + token->str.size()) {
+                    return Fail(compiler::ParseError::kInvalidNumber, token->offset);
+                }
+                if (errno == ERANGE && (num == HUGE_VAL || num == -HUGE_VAL)) {
+                    return Fail(compiler::ParseError::kNumberOutOfRange, token->offset);
+                }
+                cell->kind = Cell::kFloat;
+                cell->float_value = num;
+                return true;
+            }
+            case compiler::TokenType::kString:
+                cell->kind = Cell::kString;
+                cell->str = StringView(token->str);
+                return true;
+            case compiler::TokenType::kLbrack:
+            case compiler::TokenType::kLcurly:
+                cell->kind = Cell::kContainer;
+                return SkipValue(token);
+            default:
+                return Unexpected(*token);
+            }
+        }
+
+        // Consumes the value that token starts, containers only need to be well nested.
+        bool SkipValue(compiler::Token* token) {
+            size_t depth = 0;
+            do {
+                switch (token->type) {
+                case compiler::TokenType::kLbrack:
+                case compiler::TokenType::kLcurly:
+                    ++depth;
+                    break;
+                case compiler::TokenType::kRbrack:
+                case compiler::TokenType::kRcurly:
+                    if (depth == 0) {
+                        return Unexpected(*token);
+                    }
+                    --depth;
+                    break;
+                case compiler::TokenType::kEof:
+                    return Unexpected(*token);
+                default:
+                    break;
+                }
+                if (depth == 0) {
+                    return true;
+                }
+            } while (Next(token));
+            return false;
+        }
+
+        bool Next(compiler::Token* token) {
+            if (!lexer_->NextToken(token)) {
+                return Fail(lexer_->Error(), lexer_->ErrorOffset());
+            }
+            return true;
+        }
+
+        bool Unexpected(const compiler::Token& token) noexcept {
+            return Fail(token.type == compiler::TokenType::kEof ? compiler::ParseError::kUnexpectedEof : compiler::ParseError::kUnexpectedToken, token.offset);
+        }
+
+        bool Fail(compiler::ParseError error, size_t offset) noexcept {
+            if (error_ == compiler::ParseError::kNone) {
+                error_ = error;
+                error_offset_ = offset;
+            }
+            return false;
+        }
+
+    private:
+        compiler::Lexer* lexer_;
+        ColumnarTable* table_;
+        std::string key_;
+        compiler::ParseError error_ = compiler::ParseError::kNone;
+        size_t error_offset_ = 0;
+    };
+
+private:
+    std::vector<Column> columns_;
+    size_t rows_ = 0;
+    size_t next_column_ = 0;
+    bool valid_ = false;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_COLUMNAR_HPP_
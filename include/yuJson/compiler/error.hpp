@@ -0,0 +1,45 @@
+#ifndef YUJSON_COMPILER_ERROR_HPP_
+#define YUJSON_COMPILER_ERROR_HPP_
+
+namespace yuJson {
+namespace compiler {
+
+enum class ParseError {
+    kNone = 0,
+    kUnexpectedEof,
+    kInvalidLiteral,
+    kInvalidNumber,
+    kNumberOutOfRange,
+    kInvalidString,
+    kUnexpectedToken,
+    kTrailingCharacters,
+    kDepthExceeded,
+    kInvalidUtf8,
+    kReadFailed,
+    kRejected,
+    kWriteFailed,
+};
+
+inline const char* ParseErrorString(ParseError error) noexcept {
+    switch (error) {
+    case ParseError::kNone: return "no error";
+    case ParseError::kUnexpectedEof: return "unexpected end of input";
+    case ParseError::kInvalidLiteral: return "invalid literal";
+    case ParseError::kInvalidNumber: return "invalid number";
+    case ParseError::kNumberOutOfRange: return "number out of range";
+    case ParseError::kInvalidString: return "invalid string";
+    case ParseError::kUnexpectedToken: return "unexpected token";
+    case ParseError::kTrailingCharacters: return "trailing characters after the value";
+    case ParseError::kDepthExceeded: return "nesting too deep";
+    case ParseError::kInvalidUtf8: return "invalid UTF-8";
+    case ParseError::kReadFailed: return "reading the input failed";
+    case ParseError::kRejected: return "rejected by the event handler";
+    case ParseError::kWriteFailed: return "writing the output failed";
+    }
+    return "unknown error";
+}
+
+} // namespace compiler
+} // namespace yuJson
+
+#endif // YUJSON_COMPILER_ERROR_HPP_
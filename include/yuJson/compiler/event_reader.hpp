@@ -0,0 +1,309 @@
+#ifndef YUJSON_COMPILER_EVENT_READER_HPP_
+#define YUJSON_COMPILER_EVENT_READER_HPP_
+
+#include <vector>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+#include <yuJson/string_view.hpp>
+#include <yuJson/compiler/lexer.hpp>
+#include <yuJson/compiler/parser.hpp>
+
+namespace yuJson {
+namespace compiler {
+
+/*
+* Reports a document as a stream of events instead of building it, SAX style.
+* The handler provides Null(), Boolean(bool), Int(int64_t), Float(double), String(StringView),
+* StartObject(), Key(StringView), EndObject(), StartArray() and EndArray(), each returning false to stop.
+* Strings and keys are only valid during the call. A stop by the handler fails with kRejected.
+*/
+class EventReader {
+public:
+    EventReader(Lexer* lexer, const ParseOptions& options = ParseOptions{}) : lexer_(lexer), options_(options) {
+        lexer_->SetRawStrings(false);
+        lexer_->SetValidateUtf8(options.validate_utf8);
+    }
+
+public:
+    // Reads one whole document, only whitespace may follow the value.
+    template <typename Handler>
+    bool Run(Handler* handler) {
+        stack_.clear();
+        Token& token = token_;
+        do {
+            // a value starts here
+            if (!Next(&token)) {
+                return false;
+            }
+            bool accepted = true;
+            bool opened = false;
+            switch (token.type) {
+            case TokenType::kNull:
+                accepted = handler->Null();
+                break;
+            case TokenType::kTrue:
+            case TokenType::kFalse:
+                accepted = handler->Boolean(token.type == TokenType::kTrue);
+                break;
+            case TokenType::kNumberInt: {
+                const char* begin = token.str.c_str();
+                char* end;
+                errno = 0;
+                auto num = std::strtoll(begin, &end, 10);
+                if (end != begin + token.str.size()) {
+                    return Fail(ParseError::kInvalidNumber, token.offset);
+                }
+                if (errno == ERANGE) {
+                    return Fail(ParseError::kNumberOutOfRange, token.offset);
+                }
+                accepted = handler->Int(static_cast<int64_t>(num));
+                break;
+            }
+#ifndef YUJSON_DISABLE_FLOAT
+            case TokenType::kNumberFloat: {
+                const char* begin = token.str.c_str();
+                char* end;
+                errno = 0;
+                auto num = std::strtod(begin, &end);
+                if (end != begin + token.str.size()) {
+                    return Fail(ParseError::kInvalidNumber, token.offset);
+                }
+                if (errno == ERANGE && (num == HUGE_VAL || num == -HUGE_VAL)) {
+                    return Fail(ParseError::kNumberOutOfRange, token.offset);
+                }
+                accepted = handler->Float(num);
+                break;
+            }
+#endif
+            case TokenType::kString:
+                accepted = handler->String(StringView(token.str));
+                break;
+            case TokenType::kLbrack:
+            case TokenType::kLcurly: {
+                if (stack_.size() >= options_.max_depth) {
+                    return Fail(ParseError::kDepthExceeded, token.offset);
+                }
+                bool is_object = token.type == TokenType::kLcurly;
+                accepted = is_object ? handler->StartObject() : handler->StartArray();
+                stack_.push_back(is_object);
+                opened = true;
+                break;
+            }
+            default:
+                return Unexpected(token);
+            }
+            if (!accepted) {
+                return Fail(ParseError::kRejected, token.offset);
+            }
+
+            if (opened) {
+                bool is_object = stack_.back();
+                if (!Next(&token)) {
+                    return false;
+                }
+                if (token.type == (is_object ? TokenType::kRcurly : TokenType::kRbrack)) {
+                    if (!Close(handler, token)) {
+                        return false;
+                    }
+                }
+                else if (!is_object) {
+                    // the token starts the first element
+                    lexer_->PutBack(token);
+                    continue;
+                }
+                else {
+                    if (!ReadKey(handler, &token)) {
+                        return false;
+                    }
+                    continue;
+                }
+            }
+
+            // a value just ended, close the containers that end with it
+            while (!stack_.empty()) {
+                bool is_object = stack_.back();
+                if (!Next(&token)) {
+                    return false;
+                }
+                if (token.type == (is_object ? TokenType::kRcurly : TokenType::kRbrack)) {
+                    if (!Close(handler, token)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (token.type != TokenType::kComma) {
+                    return Unexpected(token);
+                }
+                if (is_object) {
+                    if (!Next(&token)) {
+                        return false;
+                    }
+                    if (!ReadKey(handler, &token)) {
+                        return false;
+                    }
+                }
+                break;
+            }
+        } while (!stack_.empty());
+
+        if (!Next(&token)) {
+            return false;
+        }
+        if (token.type != TokenType::kEof) {
+            return Fail(ParseError::kTrailingCharacters, token.offset);
+        }
+        return true;
+    }
+
+    // The first error met, reading stops there.
+    ParseError Error() const noexcept {
+        return error_;
+    }
+
+    size_t ErrorOffset() const noexcept {
+        return error_offset_;
+    }
+
+private:
+    template <typename Handler>
+    bool Close(Handler* handler, const Token& token) {
+        bool is_object = stack_.back();
+        stack_.pop_back();
+        if (!(is_object ? handler->EndObject() : handler->EndArray())) {
+            return Fail(ParseError::kRejected, token.offset);
+        }
+        return true;
+    }
+
+    // token holds the key, the following colon is consumed.
+    template <typename Handler>
+    bool ReadKey(Handler* handler, Token* token) {
+        if (token->type != TokenType::kString) {
+            return Unexpected(*token);
+        }
+        if (!handler->Key(StringView(token->str))) {
+            return Fail(ParseError::kRejected, token->offset);
+        }
+        if (!Next(token)) {
+            return false;
+        }
+        if (token->type != TokenType::kColon) {
+            return Unexpected(*token);
+        }
+        return true;
+    }
+
+    bool Next(Token* token) noexcept {
+        if (!lexer_->NextToken(token)) {
+            return Fail(lexer_->Error(), lexer_->ErrorOffset());
+        }
+        return true;
+    }
+
+    bool Unexpected(const Token& token) noexcept {
+        return Fail(token.type == TokenType::kEof ? ParseError::kUnexpectedEof : ParseError::kUnexpectedToken, token.offset);
+    }
+
+    bool Fail(ParseError error, size_t offset) noexcept {
+        if (error_ == ParseError::kNone) {
+            error_ = error;
+            error_offset_ = offset;
+        }
+        return false;
+    }
+
+private:
+    Lexer* lexer_;
+    ParseOptions options_;
+    std::vector<bool> stack_;       // true for objects
+    Token token_;
+    ParseError error_ = ParseError::kNone;
+    size_t error_offset_ = 0;
+};
+
+/*
+* Reports an existing tree to an EventReader handler, in the order EventReader would read its text.
+* Walks without recursion, false when the handler stopped.
+*/
+template <typename Handler>
+bool EmitEvents(value::ValueInterface* root, Handler* handler) {
+    struct Frame {
+        value::ValueInterface* node;
+        size_t index;
+        value::ValuePtrtMap::iterator iter;
+    };
+    std::vector<Frame> stack;
+    auto visit = [&](value::ValueInterface* value) {
+        if (!value) {
+            return handler->Null();
+        }
+        switch (value->Type()) {
+        case value::ValueType::kBoolean:
+            return handler->Boolean(value->GetBoolean().Get());
+        case value::ValueType::kNumberInt:
+            return handler->Int(value->GetNumberInt().Get());
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            return handler->Float(value->GetNumberFloat().Get());
+#endif
+        case value::ValueType::kString: {
+            auto& str = value->GetString().Get();
+            return handler->String(StringView(str.data(), str.size()));
+        }
+        case value::ValueType::kArray:
+            stack.push_back(Frame{ value, 0, value::ValuePtrtMap::iterator() });
+            return handler->StartArray();
+        case value::ValueType::kObject:
+            stack.push_back(Frame{ value, 0, value->GetObject().GetMap().begin() });
+            return handler->StartObject();
+        default:
+            return handler->Null();
+        }
+    };
+    if (!visit(root)) {
+        return false;
+    }
+    while (!stack.empty()) {
+        // visit may grow the stack, so nothing refers into it across the call
+        auto node = stack.back().node;
+        value::ValueInterface* child;
+        if (node->IsArray()) {
+            auto& vec = node->GetArray().GetVector();
+            auto index = stack.back().index++;
+            if (index == vec.size()) {
+                stack.pop_back();
+                if (!handler->EndArray()) {
+                    return false;
+                }
+                continue;
+            }
+            child = vec[index].get();
+        }
+        else {
+            auto iter = stack.back().iter;
+            if (iter == node->GetObject().GetMap().end()) {
+                stack.pop_back();
+                if (!handler->EndObject()) {
+                    return false;
+                }
+                continue;
+            }
+            ++stack.back().iter;
+            if (!handler->Key(StringView(iter->first))) {
+                return false;
+            }
+            child = iter->second.get();
+        }
+        if (!visit(child)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace compiler
+} // namespace yuJson
+
+#endif // YUJSON_COMPILER_EVENT_READER_HPP_
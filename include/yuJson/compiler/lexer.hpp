@@ -3,49 +3,58 @@
 
 #include <string>
 #include <cstring>
+#include <chrono>
+
+#include <yuJson/string_view.hpp>
+#include <yuJson/compiler/token.hpp>
+#include <yuJson/compiler/error.hpp>
+#include <yuJson/stats.hpp>
+#include <yuJson/escape.hpp>
+#include <yuJson/utf8.hpp>
+#include <yuJson/compiler/reader.hpp>
 
 namespace yuJson {
 namespace compiler {
 
-enum class TokenType {
-    kNone = 0,
-    kEof,
-    kNull,
-    kTrue,
-    kFalse,
-    kNumberInt,
-    kNumberFloat,
-    kString,
-    kLbrack,
-    kRbrack,
-    kLcurly,
-    kRcurly,
-    kComma,
-    kColon,
-    kMinus,
-};
-
-struct Token {
-    TokenType type{ TokenType::kNone };
-    std::string str{};
-};
-
 class Lexer {
 public:
     Lexer(const std::string& src) : m_src(src), m_idx(0) {
         m_nextToken.type = TokenType::kNone;
     }
+    Lexer(std::string&& src) : m_src(std::move(src)), m_idx(0) {
+        m_nextToken.type = TokenType::kNone;
+    }
+    // Pulls the input from source as it goes, offsets still count from the start of the whole input.
+    explicit Lexer(InputSource* source) : m_idx(0), m_source(source) {
+        m_nextToken.type = TokenType::kNone;
+    }
 
 public:
+    // Starts over on new input, the buffers keep their capacity.
+    void Reset(const char* src, size_t size) {
+        m_src.assign(src, size);
+        m_idx = 0;
+        m_base = 0;
+        m_source = nullptr;
+        m_nextToken.type = TokenType::kNone;
+        m_error = ParseError::kNone;
+        m_errorOffset = 0;
+        m_keep = kKeepNone;
+    }
+
     char NextChar() noexcept {
         if (m_idx < m_src.size()) {
             return m_src[m_idx++];
         }
+        if (m_source && Refill()) {
+            return m_src[m_idx++];
+        }
         return 0;
     }
 
     bool MatchStr(const char* str) noexcept {
         size_t len = strlen(str);
+        while (m_idx + len > m_src.size() && m_source && Refill());
         if (m_idx + len <= m_src.size()) {
             int res = memcmp(str, m_src.c_str() + m_idx, len);
             if (res == 0) {
@@ -78,14 +87,110 @@ public:
             m_nextToken.type = TokenType::kNone;
             return true;
         }
+#ifdef YUJSON_ENABLE_STATS
+        if (stats_) {
+            auto begin = std::chrono::steady_clock::now();
+            bool success = ReadToken(token);
+            stats_->lex_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            if (success) {
+                stats_->tokens[static_cast<size_t>(token->type)]++;
+            }
+            return success;
+        }
+#endif
+        return ReadToken(token);
+    }
+
+    // Makes token the next one returned, at most one token can be put back.
+    void PutBack(const Token& token) {
+        m_nextToken = token;
+    }
+
+    bool MatchToken(TokenType type) noexcept {
+        Token token;
+        if (!LookAhead(&token)) {
+            return false;
+        }
+        if (token.type != type) {
+            return false;
+        }
+        NextToken(nullptr);
+        return true;
+    }
+
+    // Strings with escapes are returned as written, token.escaped tells which ones need Unescape.
+    void SetRawStrings(bool raw) noexcept {
+        m_rawStrings = raw;
+    }
+
+    void SetValidateUtf8(bool validate) noexcept {
+        m_validateUtf8 = validate;
+    }
+
+    void SetStats(Stats* stats) noexcept {
+#ifdef YUJSON_ENABLE_STATS
+        stats_ = stats;
+#else
+        (void)stats;
+#endif
+    }
+
+    // Reason and byte offset of the last token that failed to lex.
+    ParseError Error() const noexcept {
+        return m_error;
+    }
+
+    size_t ErrorOffset() const noexcept {
+        return m_errorOffset;
+    }
+
+    // Offset of the next unread character, a looked ahead token counts as read.
+    size_t Offset() const noexcept {
+        return m_base + m_idx;
+    }
 
+    // Input from offset on stays buffered when a streamed input is compacted, see Text.
+    void Keep(size_t offset) noexcept {
+        m_keep = offset;
+    }
+
+    // The input between two offsets, from the kept offset or the last token on up to Offset().
+    // Valid until the next token is read.
+    StringView Text(size_t begin, size_t end) const noexcept {
+        return StringView(m_src.data() + (begin - m_base), end - begin);
+    }
+
+private:
+    // offset is relative to the buffer.
+    bool Fail(ParseError error, size_t offset) noexcept {
+        m_error = error;
+        m_errorOffset = m_base + offset;
+        return false;
+    }
+
+    // Appends the next chunk of the source, a token that straddles the chunks ends up contiguous.
+    bool Refill() noexcept {
+        return m_source->ReadChunk(&m_src);
+    }
+
+    bool ReadToken(Token* token) noexcept {
+        if (m_source && m_idx >= kCompactBytes) {
+            // only between tokens, so positions taken inside a token stay valid
+            size_t drop = m_keep - m_base < m_idx ? m_keep - m_base : m_idx;
+            m_src.erase(0, drop);
+            m_base += drop;
+            m_idx -= drop;
+        }
         char c;
         while ((c = NextChar()) && (c == ' ' || c == '\t' || c == '\r' || c == '\n'));
 
         if (c == 0) {
             token->type = TokenType::kEof;
+            token->offset = m_base + m_idx;
             return true;
         }
+        size_t begin = m_idx - 1;
+        token->offset = m_base + begin;
         switch (c) {
         case '{':
             token->type = TokenType::kLcurly;
@@ -160,9 +265,9 @@ public:
                 }
                 ++i;
             } while (c = NextChar());
-            auto end_char = token->str.at(token->str.size() - 1);
-            if (is_float && (end_char < '0' || end_char > '9')) {
-                return false;
+            auto end_char = token->str.back();
+            if (end_char < '0' || end_char > '9') {
+                return Fail(ParseError::kInvalidNumber, begin);
             }
             token->type = is_float ? TokenType::kNumberFloat : TokenType::kNumberInt;
             return true;
@@ -170,128 +275,67 @@ public:
 
         if (c == '\"') {
             token->type = TokenType::kString;
-            token->str = "";
-            bool escape = false;
-            while (c = NextChar()) {
+            size_t body = m_idx;
+            bool escaped = false;
+            // a NUL byte ends the string like the end of the input does
+            while ((c = NextChar()) && c != '\"') {
                 if (c == '\\') {
-                    escape = true;
-                    continue;
-                }
-                if (escape == false && c == '\"') {
-                    break;
-                }
-                if (escape) {
-                    escape = false;
-                    if (c == '\"' || c == '/' || c == '\\') {
-                        token->str += c;
-                    }
-                    else if (c == 'b') {
-                        token->str += '\b';
-                    }
-                    else if (c == 'f') {
-                        token->str += '\f';
-                    }
-                    else if (c == 'n') {
-                        token->str += '\n';
+                    escaped = true;
+                    if (!(c = NextChar())) {
+                        break;
                     }
-                    else if (c == 'r') {
-                        token->str += '\r';
-                    }
-                    else if (c == 'u') {
-                        auto make_unicode_hex = [&](int& hex) -> bool {
-                            std::string hex_str;
-                            for (size_t i = 0; i < 4; i++) {
-                                auto hex_c = NextChar();
-                                if (hex_c) {
-                                    hex_str += hex_c;
-                                }
-                                else {
-                                    return false;
-                                }
-                            }
-                            hex = std::stoi(hex_str, nullptr, 16);
-                            return true;
-                        };
-                        
-                        int hex_high;
-                        if (!make_unicode_hex(hex_high)) {
-                            return false;
-                        }
-                        int codepoint;
-                        if (hex_high >= 0xd800 && hex_high <= 0xdbff) {
-                            if (!MatchStr("\\u")) {
-                                return false;
-                            }
-                            int hex_low;
-                            if (!make_unicode_hex(hex_low)) {
-                                return false;
-                            }
-                            if (hex_low < 0xdc00 || hex_low > 0xe000) {
-                                return false;
-                            }
-                            codepoint = 0x10000 + (hex_high - 0xD800) * 0x400 + (hex_low - 0xDC00);
-                        }
-                        else {
-                            codepoint = hex_high;
-                        }
-
-                        if (codepoint >= 0x10000 && codepoint <= 0x10ffff) {
-                            token->str += 0xf0 | ((codepoint >> 18) & 0x07);
-                            token->str += 0x80 | ((codepoint >> 12) & 0x3f);
-                            token->str += 0x80 | ((codepoint >> 6) & 0x3f);
-                            token->str += 0x80 | ((codepoint) & 0x3f);
-                        }
-                        else if (codepoint >= 0x800 && codepoint <= 0xffff) {
-                            token->str += 0xe0 | ((codepoint >> 12) & 0x0f);
-                            token->str += 0x80 | ((codepoint >> 6) & 0x3f);
-                            token->str += 0x80 | ((codepoint) & 0x3f);
-                        }
-                        else if (codepoint < 0x7ff) {
-                            token->str += 0xc0 | ((codepoint >> 6) & 0x0f);
-                            token->str += 0x80 | (codepoint & 0x3f);
-                        }
-                        else if (codepoint < 0x7f) {
-                            token->str += codepoint;
-                        }
-                        else {
-                            return false;
-                        }
-                        
-                    }
-                    else {
-                        token->str += '\\';
-                        token->str += c;
-                    }
-                }
-                else {
-                    
-                    token->str += c;
                 }
             }
             if (c != '\"') {
-                return false;
+                return Fail(ParseError::kInvalidString, begin);
+            }
+            const char* body_begin = m_src.data() + body;
+            const char* body_end = m_src.data() + m_idx - 1;
+            size_t error_index = 0;
+            if (m_validateUtf8 && !ValidateUtf8(body_begin, body_end - body_begin, &error_index)) {
+                return Fail(ParseError::kInvalidUtf8, body + error_index);
+            }
+            token->escaped = escaped && m_rawStrings;
+            if (!escaped) {
+                token->str.assign(body_begin, body_end);
+            }
+            else if (m_rawStrings) {
+                // keep the escapes, only check that they decode
+                NullSink sink;
+                if (!Unescape(body_begin, body_end, &sink, &error_index)) {
+                    return Fail(ParseError::kInvalidString, body + error_index);
+                }
+                token->str.assign(body_begin, body_end);
+            }
+            else {
+                token->str.clear();
+                if (!Unescape(body_begin, body_end, &token->str, &error_index)) {
+                    return Fail(ParseError::kInvalidString, body + error_index);
+                }
             }
             return true;
         }
-        return false;
-    }
-
-    bool MatchToken(TokenType type) noexcept {
-        Token token;
-        if (!LookAhead(&token)) {
-            return false;
-        }
-        if (token.type != type) {
-            return false;
-        }
-        NextToken(nullptr);
-        return true;
+        return Fail(ParseError::kInvalidLiteral, begin);
     }
 
 private:
+    static constexpr size_t kCompactBytes = 64 * 1024;
+    static constexpr size_t kKeepNone = static_cast<size_t>(-1);
+
     std::string m_src;
     size_t m_idx;
+    // offset of m_src[0] in the input, the consumed part of a streamed input is dropped
+    size_t m_base = 0;
+    InputSource* m_source = nullptr;
     Token m_nextToken;
+    ParseError m_error = ParseError::kNone;
+    size_t m_errorOffset = 0;
+    size_t m_keep = kKeepNone;
+    bool m_rawStrings = false;
+    bool m_validateUtf8 = false;
+#ifdef YUJSON_ENABLE_STATS
+    Stats* stats_ = nullptr;
+#endif
 };
 
 } // namespace compiler
@@ -0,0 +1,178 @@
+#ifndef YUJSON_COMPILER_PARALLEL_PARSER_HPP_
+#define YUJSON_COMPILER_PARALLEL_PARSER_HPP_
+
+#include <vector>
+#include <future>
+#include <algorithm>
+
+#include <yuJson/value/value.hpp>
+#include <yuJson/compiler/lexer.hpp>
+#include <yuJson/compiler/parser.hpp>
+
+namespace yuJson {
+namespace compiler {
+
+/*
+* Parses a top-level array or object on several threads.
+* A structural pre-scan that tracks string state finds commas at depth 1,
+* the members between them are parsed as independent segments and stitched together.
+* Anything the pre-scan or a segment cannot handle falls back to the sequential Parser.
+*/
+class ParallelParser {
+public:
+    ParallelParser(const std::string& src, size_t thread_count) : src_(src), thread_count_(thread_count) { }
+
+public:
+    value::ValuePtr ParseValue() {
+        std::vector<size_t> splits;
+        if (thread_count_ > 1 && src_.size() >= kMinBytes && Scan(&splits)) {
+            auto value = ParseSegments(splits);
+            if (value) {
+                return value;
+            }
+        }
+        Lexer lexer(src_);
+        Parser parser(&lexer);
+        return parser.Parse();
+    }
+
+private:
+    // Fills splits with the open bracket, the chosen depth 1 commas and the matching close bracket.
+    bool Scan(std::vector<size_t>* splits) {
+        size_t i = 0;
+        while (i < src_.size() && (src_[i] == ' ' || src_[i] == '\t' || src_[i] == '\r' || src_[i] == '\n')) {
+            ++i;
+        }
+        if (i == src_.size() || (src_[i] != '[' && src_[i] != '{')) {
+            return false;
+        }
+        splits->push_back(i);
+
+        size_t chunk_size = (src_.size() - i) / thread_count_ + 1;
+        size_t next_split = i + chunk_size;
+        size_t depth = 0;
+        bool in_string = false;
+        for (; i < src_.size(); i++) {
+            char c = src_[i];
+            if (in_string) {
+                if (c == '\\') {
+                    ++i;
+                }
+                else if (c == '\"') {
+                    in_string = false;
+                }
+                continue;
+            }
+            switch (c) {
+            case '\"':
+                in_string = true;
+                break;
+            case '[':
+            case '{':
+                ++depth;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0) {
+                    splits->push_back(i);
+                    while (++i < src_.size()) {
+                        if (src_[i] != ' ' && src_[i] != '\t' && src_[i] != '\r' && src_[i] != '\n') {
+                            return false;
+                        }
+                    }
+                    return splits->size() > 2;
+                }
+                break;
+            case ',':
+                if (depth == 1 && i >= next_split) {
+                    splits->push_back(i);
+                    next_split = i + chunk_size;
+                }
+                break;
+            }
+        }
+        return false;
+    }
+
+    value::ValuePtr ParseSegments(const std::vector<size_t>& splits) {
+        bool is_array = src_[splits.front()] == '[';
+        size_t segment_count = splits.size() - 1;
+        std::vector<value::ValuePtr> segments(segment_count);
+        // the workers allocate from the caller's resource, which therefore has to be thread-safe
+        auto resource = GetDefaultResource();
+        auto parse_segment = [&](size_t i) {
+            MemoryResourceScope resource_scope(resource);
+            size_t begin = splits[i] + 1;
+            size_t end = splits[i + 1];
+            // a segment without a value comes from a stray comma, the sequential parser reports it
+            if (src_.find_first_not_of(" \t\r\n", begin) >= end) {
+                return;
+            }
+            std::string text;
+            text.reserve(end - begin + 2);
+            text += is_array ? '[' : '{';
+            text.append(src_, begin, end - begin);
+            text += is_array ? ']' : '}';
+            Lexer lexer(std::move(text));
+            Parser parser(&lexer);
+            auto value = parser.ParseValue();
+            Token token;
+            if (!lexer.NextToken(&token) || token.type != TokenType::kEof) {
+                return;
+            }
+            segments[i] = std::move(value);
+        };
+        std::vector<std::future<void>> workers;
+        for (size_t i = 1; i < segment_count; i++) {
+            workers.push_back(std::async(std::launch::async, parse_segment, i));
+        }
+        parse_segment(0);
+        for (auto& worker : workers) {
+            worker.get();
+        }
+
+        for (auto& segment : segments) {
+            if (!segment) {
+                return nullptr;
+            }
+        }
+        if (is_array) {
+            auto array = std::make_unique<value::ArrayValue>();
+            size_t size = 0;
+            for (auto& segment : segments) {
+                size += segment->GetArray().GetVector().size();
+            }
+            array->GetVector().reserve(size);
+            for (auto& segment : segments) {
+                for (auto& element : segment->GetArray().GetVector()) {
+                    if (!element) {
+                        return nullptr;
+                    }
+                    array->PushBack(std::move(element));
+                }
+            }
+            return array;
+        }
+        auto object = std::make_unique<value::ObjectValue>();
+        for (auto& segment : segments) {
+            for (auto& member : segment->GetObject().GetMap()) {
+                if (!member.second) {
+                    return nullptr;
+                }
+                object->Set(member.first, std::move(member.second));
+            }
+        }
+        return object;
+    }
+
+private:
+    static constexpr size_t kMinBytes = 1024 * 1024;
+
+    const std::string& src_;
+    size_t thread_count_;
+};
+
+} // namespace compiler
+} // namespace yuJson
+
+#endif // YUJSON_COMPILER_PARALLEL_PARSER_HPP_
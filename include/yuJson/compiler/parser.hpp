@@ -2,9 +2,15 @@
 #define YUJSON_COMPILER_PARSER_HPP_
 
 #include <memory>
+#include <vector>
+#include <limits>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 
 #include <yuJson/value/value.hpp>
 #include <yuJson/compiler/lexer.hpp>
+#include <yuJson/stats.hpp>
 
 namespace yuJson {
 namespace compiler {
@@ -19,122 +25,374 @@ object -> "{" [string ":" value {"," string ":" value} ] "}"
 array -> "[" [value {"," value} ] "]"
 */
 
+struct ParseOptions {
+    // Deepest array / object nesting accepted, deeper input fails with kDepthExceeded.
+    // Unbounded by default like the recursive parser it replaced, set it for untrusted input.
+    size_t max_depth = std::numeric_limits<size_t>::max();
+    // Numbers keep their input text and are converted on first access, Print writes the text back unchanged.
+    // Integers beyond the int64 range are accepted, see Json::Uint64 / Json::RawNumber.
+    bool lazy_numbers = false;
+    // Strings keep their input text and are unescaped on first access, Print copies untouched ones back as is.
+    // Object keys are always decoded.
+    bool lazy_strings = false;
+    // Strings and keys must be well-formed UTF-8, otherwise the parse fails with kInvalidUtf8
+    // at the first bad byte.
+    bool validate_utf8 = false;
+};
+
+/*
+* Containers are parsed with an explicit stack of frames instead of recursion,
+* so the nesting depth costs heap memory only and can be bounded with ParseOptions::max_depth.
+* The stack is kept between calls on the same Parser.
+*/
 class Parser {
 public:
-    Parser(Lexer* lexer) : lexer_(lexer) { }
+    Parser(Lexer* lexer, const ParseOptions& options = ParseOptions{}) : lexer_(lexer), options_(options) {
+        lexer_->SetRawStrings(options.lazy_strings);
+        lexer_->SetValidateUtf8(options.validate_utf8);
+    }
 
 public:
-    value::ValuePtr ParseValue() {
+    void SetStats(Stats* stats) noexcept {
+#ifdef YUJSON_ENABLE_STATS
+        stats_ = stats;
+#else
+        (void)stats;
+#endif
+    }
+
+    // Parses a whole document, only whitespace may follow the value.
+    value::ValuePtr Parse() {
+        auto value = ParseValue();
+        if (!value) {
+            return nullptr;
+        }
         Token token;
         if (!lexer_->NextToken(&token)) {
-            return nullptr;
+            return LexerFail();
         }
-        switch (token.type) {
-        case TokenType::kNull: {
-            return std::make_unique<value::NullValue>();
+        if (token.type != TokenType::kEof) {
+            return Fail(ParseError::kTrailingCharacters, token.offset);
         }
-        case TokenType::kTrue: {
-            return std::make_unique<value::BooleanValue>(true);
+        return value;
+    }
+
+    value::ValuePtr ParseValue() {
+        stack_.clear();
+        value::ValuePtr root;
+        // a member, so its string buffer is reused by the next document
+        Token& token = token_;
+        do {
+            // a value starts here
+            if (!lexer_->NextToken(&token)) {
+                return LexerFail();
+            }
+            value::ValuePtr value;
+            bool opened = false;
+            switch (token.type) {
+            case TokenType::kNull: {
+                value = MakeValue<value::NullValue>();
+                break;
+            }
+            case TokenType::kTrue: {
+                value = MakeValue<value::BooleanValue>(true);
+                break;
+            }
+            case TokenType::kFalse: {
+                value = MakeValue<value::BooleanValue>(false);
+                break;
+            }
+            case TokenType::kNumberInt: {
+                value = ParseNumberInt(token);
+                break;
+            }
+#ifndef YUJSON_DISABLE_FLOAT
+            case TokenType::kNumberFloat: {
+                value = ParseNumberFloat(token);
+                break;
+            }
+#endif
+            case TokenType::kString: {
+                if (options_.lazy_strings) {
+                    auto str = MakeValue<value::RawStringValue>(StringView(token.str), token.escaped);
+#ifdef YUJSON_ENABLE_STATS
+                    CountString(str->Raw());
+#endif
+                    value = std::move(str);
+                    break;
+                }
+                auto str = MakeValue<value::StringValue>(token.str);
+#ifdef YUJSON_ENABLE_STATS
+                CountString(str->Get());
+#endif
+                value = std::move(str);
+                break;
+            }
+            case TokenType::kLbrack:
+            case TokenType::kLcurly: {
+                if (stack_.size() >= options_.max_depth) {
+                    return Fail(ParseError::kDepthExceeded, token.offset);
+                }
+                Frame frame;
+                if (token.type == TokenType::kLbrack) {
+                    auto array = MakeValue<value::ArrayValue>();
+                    frame.array = array.get();
+                    value = std::move(array);
+                }
+                else {
+                    auto object = MakeValue<value::ObjectValue>();
+                    frame.object = object.get();
+                    value = std::move(object);
+                }
+                Attach(&root, std::move(value));
+                stack_.push_back(std::move(frame));
+                opened = true;
+#ifdef YUJSON_ENABLE_STATS
+                if (stats_ && stack_.size() > stats_->max_depth) {
+                    stats_->max_depth = stack_.size();
+                }
+#endif
+                break;
+            }
+            default: {
+                return Unexpected(token);
+            }
+            }
+
+            if (opened) {
+                auto& frame = stack_.back();
+                if (!lexer_->NextToken(&token)) {
+                    return LexerFail();
+                }
+                if (token.type == (frame.array ? TokenType::kRbrack : TokenType::kRcurly)) {
+                    stack_.pop_back();
+                }
+                else if (frame.array) {
+                    // the token starts the first element
+                    lexer_->PutBack(token);
+                    continue;
+                }
+                else {
+                    if (!ParseKey(&token, &frame.key)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+            }
+            else {
+                if (!value) {
+                    return nullptr;
+                }
+                Attach(&root, std::move(value));
+            }
+
+            // a value just ended, close the containers that end with it
+            while (!stack_.empty()) {
+                auto& frame = stack_.back();
+                if (!lexer_->NextToken(&token)) {
+                    return LexerFail();
+                }
+                if (token.type == (frame.array ? TokenType::kRbrack : TokenType::kRcurly)) {
+                    stack_.pop_back();
+                    continue;
+                }
+                if (token.type != TokenType::kComma) {
+                    return Unexpected(token);
+                }
+                if (frame.object) {
+                    if (!lexer_->NextToken(&token)) {
+                        return LexerFail();
+                    }
+                    if (!ParseKey(&token, &frame.key)) {
+                        return nullptr;
+                    }
+                }
+                break;
+            }
+        } while (!stack_.empty());
+        return root;
+    }
+
+    // Forgets the error of the previous document, for a Parser that is reused with Lexer::Reset.
+    void Reset() noexcept {
+        error_ = ParseError::kNone;
+        error_offset_ = 0;
+    }
+
+    // The first error met, parsing stops there.
+    ParseError Error() const noexcept {
+        return error_;
+    }
+
+    size_t ErrorOffset() const noexcept {
+        return error_offset_;
+    }
+
+private:
+    value::ValuePtr ParseNumberInt(const Token& token) {
+        if (options_.lazy_numbers) {
+            return MakeRawNumber<value::RawNumberIntValue>(token);
         }
-        case TokenType::kFalse: {
-            return std::make_unique<value::BooleanValue>(false);
+        const char* begin = token.str.c_str();
+        char* end;
+        errno = 0;
+        auto num = std::strtoll(begin, &end, 10);
+        if (end != begin + token.str.size()) {
+            return Fail(ParseError::kInvalidNumber, token.offset);
         }
-        case TokenType::kNumberInt: {
-            return std::make_unique<value::NumberIntValue>(int64_t{ std::stoll(token.str) });
+        if (errno == ERANGE) {
+            return Fail(ParseError::kNumberOutOfRange, token.offset);
         }
+        return MakeValue<value::NumberIntValue>(static_cast<int64_t>(num));
+    }
+
 #ifndef YUJSON_DISABLE_FLOAT
-        case TokenType::kNumberFloat: {
-            return std::make_unique<value::NumberFloatValue>(std::stod(token.str));
+    value::ValuePtr ParseNumberFloat(const Token& token) {
+        if (options_.lazy_numbers) {
+            return MakeRawNumber<value::RawNumberFloatValue>(token);
+        }
+        const char* begin = token.str.c_str();
+        char* end;
+        errno = 0;
+        auto num = std::strtod(begin, &end);
+        if (end != begin + token.str.size()) {
+            return Fail(ParseError::kInvalidNumber, token.offset);
         }
+        if (errno == ERANGE && (num == HUGE_VAL || num == -HUGE_VAL)) {
+            return Fail(ParseError::kNumberOutOfRange, token.offset);
+        }
+        return MakeValue<value::NumberFloatValue>(num);
+    }
 #endif
-        case TokenType::kString: {
-            return std::make_unique<value::StringValue>(token.str);
+
+    // The lexer has already checked the shape of the number, converting it is left to the first access.
+    template <typename T>
+    value::ValuePtr MakeRawNumber(const Token& token) {
+        auto value = MakeValue<T>(StringView(token.str));
+#ifdef YUJSON_ENABLE_STATS
+        CountString(value->GetRaw());
+#endif
+        return value;
+    }
+
+    struct Frame {
+        value::ArrayValue* array = nullptr;
+        value::ObjectValue* object = nullptr;
+        std::string key;
+    };
+
+    // token holds the key, the following colon is consumed.
+    bool ParseKey(Token* token, std::string* key) {
+        if (token->type != TokenType::kString) {
+            Unexpected(*token);
+            return false;
         }
+        if (token->escaped) {
+            size_t error_index;
+            key->clear();
+            Unescape(token->str.data(), token->str.data() + token->str.size(), key, &error_index);
         }
-        if (token.type == TokenType::kLbrack) {
-            return ParseArray();
+        else {
+            // copied, not moved: the token buffer is sized for the longest string so far and is reused
+            key->assign(token->str.data(), token->str.size());
         }
-        if (token.type == TokenType::kLcurly) {
-            return ParseObject();
+        if (!lexer_->NextToken(token)) {
+            LexerFail();
+            return false;
         }
-        return nullptr;
-
+        if (token->type != TokenType::kColon) {
+            Unexpected(*token);
+            return false;
+        }
+        return true;
     }
 
-private:
-    value::ArrayPtr ParseArray() {
-        value::ArrayPtr array = std::make_unique<value::ArrayValue>();
-        Token token;
-        if (!lexer_->LookAhead(&token)) {
-            return nullptr;
+    void Attach(value::ValuePtr* root, value::ValuePtr value) {
+        if (stack_.empty()) {
+            *root = std::move(value);
         }
-        if (token.type == TokenType::kRbrack) {
-            lexer_->NextToken(nullptr);
-            return array;
+        else if (stack_.back().array) {
+            PushBack(stack_.back().array, std::move(value));
         }
-        array->PushBack(ParseValue());
-        do {
-            Token token;
-            if (!lexer_->LookAhead(&token)) {
-                return nullptr;
-            }
-            if (token.type != TokenType::kComma) {
-                break;
-            }
-            lexer_->NextToken(nullptr);
-            array->PushBack(ParseValue());
-
-        } while (true);
-        if (!lexer_->MatchToken(TokenType::kRbrack)) {
-            return nullptr;
+        else {
+            Set(stack_.back().object, std::move(stack_.back().key), std::move(value));
         }
-        return array;
     }
 
-    value::ObjectPtr ParseObject() {
-        value::ObjectPtr object = std::make_unique<value::ObjectValue>();
-        Token token;
-        if (!lexer_->NextToken(&token)) {
-            return nullptr;
-        }
-        if (token.type == TokenType::kRcurly) {
-            return object;
+    std::nullptr_t Fail(ParseError error, size_t offset) noexcept {
+        if (error_ == ParseError::kNone) {
+            error_ = error;
+            error_offset_ = offset;
         }
-        if (token.type != TokenType::kString) {
-            return nullptr;
+        return nullptr;
+    }
+
+    std::nullptr_t LexerFail() noexcept {
+        return Fail(lexer_->Error(), lexer_->ErrorOffset());
+    }
+
+    std::nullptr_t Unexpected(const Token& token) noexcept {
+        return Fail(token.type == TokenType::kEof ? ParseError::kUnexpectedEof : ParseError::kUnexpectedToken, token.offset);
+    }
+
+    template <typename T, typename... Args>
+    std::unique_ptr<T> MakeValue(Args&&... args) {
+#ifdef YUJSON_ENABLE_STATS
+        CountAllocation(sizeof(T));
+#endif
+        return std::make_unique<T>(std::forward<Args>(args)...);
+    }
+
+    void PushBack(value::ArrayValue* array, value::ValuePtr value) {
+#ifdef YUJSON_ENABLE_STATS
+        auto& vec = array->GetVector();
+        if (vec.size() == vec.capacity()) {
+            CountAllocation((vec.capacity() ? vec.capacity() * 2 : 1) * sizeof(value::ValuePtr));
         }
-        std::string key = token.str;
-        if (!lexer_->NextToken(&token) || token.type != TokenType::kColon) {
-            return nullptr;
+#endif
+        array->PushBack(std::move(value));
+    }
+
+    void Set(value::ObjectValue* object, std::string&& key, value::ValuePtr value) {
+#ifdef YUJSON_ENABLE_STATS
+        if (!object->Exist(key)) {
+            // rb-tree node: the pair plus parent, left, right and color
+            CountAllocation(sizeof(value::ValuePtrtMap::value_type) + 4 * sizeof(void*));
+            CountString(key);
         }
-        object->Set(key, ParseValue());
-        do {
-            Token token;
-            if (!lexer_->LookAhead(&token)) {
-                return nullptr;
-            }
-            if (token.type != TokenType::kComma) {
-                break;
-            }
-            lexer_->NextToken(nullptr);
+#endif
+        object->Set(std::move(key), std::move(value));
+    }
 
-            lexer_->NextToken(&token);
-            std::string key = token.str;
+#ifdef YUJSON_ENABLE_STATS
+    void CountAllocation(size_t bytes) noexcept {
+        if (stats_) {
+            stats_->estimated_allocations++;
+            stats_->estimated_allocated_bytes += bytes;
+        }
+    }
 
-            lexer_->NextToken(&token);
-            if (token.type != TokenType::kColon) {
-                return nullptr;
-            }
-            object->Set(key, ParseValue());
-        } while (true);
-        if (!lexer_->MatchToken(TokenType::kRcurly)) {
-            return nullptr;
+    // Strings that do not fit the small string buffer own a heap allocation.
+    template <typename Str>
+    void CountString(const Str& str) noexcept {
+        auto data = str.data();
+        auto self = reinterpret_cast<const char*>(&str);
+        if (data < self || data >= self + sizeof(str)) {
+            CountAllocation(str.capacity() + 1);
         }
-        return object;
     }
+#endif
 
 private:
     Lexer* lexer_;
+    ParseOptions options_;
+    std::vector<Frame> stack_;
+    Token token_;
+    ParseError error_ = ParseError::kNone;
+    size_t error_offset_ = 0;
+#ifdef YUJSON_ENABLE_STATS
+    Stats* stats_ = nullptr;
+#endif
 };
 
 } // namespace compiler
@@ -0,0 +1,176 @@
+#ifndef YUJSON_COMPILER_READER_HPP_
+#define YUJSON_COMPILER_READER_HPP_
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace yuJson {
+namespace compiler {
+
+// Supplies the input of a Lexer in chunks, see Lexer(InputSource*).
+class InputSource {
+public:
+    virtual ~InputSource() noexcept { }
+
+public:
+    // Appends the next chunk to buffer, false once the input is exhausted.
+    virtual bool ReadChunk(std::string* buffer) = 0;
+
+    // The input ended because reading failed, not because it was complete.
+    virtual bool Failed() const noexcept {
+        return false;
+    }
+};
+
+/*
+* Reads a file descriptor or a std::istream on its own thread into a ring of chunk_count buffers,
+* so the next chunks are already being read while the lexer works on the current one.
+* The reading starts in the constructor; the destructor waits for a read that is still in progress.
+*/
+class PipelinedReader : public InputSource {
+public:
+    PipelinedReader(int fd, size_t chunk_size = kDefaultChunkSize, size_t chunk_count = 2) : fd_(fd) {
+        Start(chunk_size, chunk_count);
+    }
+    PipelinedReader(std::istream& stream, size_t chunk_size = kDefaultChunkSize, size_t chunk_count = 2) : stream_(&stream) {
+        Start(chunk_size, chunk_count);
+    }
+    ~PipelinedReader() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        free_cond_.notify_one();
+        thread_.join();
+    }
+
+    PipelinedReader(const PipelinedReader&) = delete;
+    void operator=(const PipelinedReader&) = delete;
+
+    bool ReadChunk(std::string* buffer) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        filled_cond_.wait(lock, [&] { return filled_ > 0 || done_; });
+        if (filled_ == 0) {
+            return false;
+        }
+        // the slot belongs to the consumer until it is handed back
+        auto& chunk = chunks_[head_];
+        lock.unlock();
+        buffer->append(chunk);
+        lock.lock();
+        head_ = (head_ + 1) % chunks_.size();
+        --filled_;
+        lock.unlock();
+        free_cond_.notify_one();
+        return true;
+    }
+
+    bool Failed() const noexcept override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+private:
+    void Start(size_t chunk_size, size_t chunk_count) {
+        chunk_size_ = chunk_size ? chunk_size : 1;
+        chunks_.resize(chunk_count > 1 ? chunk_count : 2);
+        for (auto& chunk : chunks_) {
+            chunk.reserve(chunk_size_);
+        }
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    void Run() {
+        size_t tail = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                free_cond_.wait(lock, [&] { return stop_ || filled_ < chunks_.size(); });
+                if (stop_) {
+                    return;
+                }
+            }
+            auto& chunk = chunks_[tail];
+            chunk.resize(chunk_size_);
+            size_t size = 0;
+            bool ok = Fill(&chunk[0], &size);
+            chunk.resize(size);
+            bool done = !ok || size < chunk_size_;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (size > 0) {
+                    tail = (tail + 1) % chunks_.size();
+                    ++filled_;
+                }
+                done_ = done;
+                failed_ = !ok;
+            }
+            filled_cond_.notify_one();
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    // Reads until the chunk is full or the input ends, false on a read error.
+    bool Fill(char* data, size_t* size) {
+        while (*size < chunk_size_) {
+            auto want = chunk_size_ - *size;
+            if (stream_) {
+                stream_->read(data + *size, static_cast<std::streamsize>(want));
+                *size += static_cast<size_t>(stream_->gcount());
+                return !stream_->bad();
+            }
+#ifdef _WIN32
+            auto got = _read(fd_, data + *size, static_cast<unsigned>(want));
+#else
+            auto got = ::read(fd_, data + *size, want);
+#endif
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (got == 0) {
+                break;
+            }
+            *size += static_cast<size_t>(got);
+        }
+        return true;
+    }
+
+private:
+    int fd_ = -1;
+    std::istream* stream_ = nullptr;
+    size_t chunk_size_ = 0;
+    std::vector<std::string> chunks_;
+    size_t head_ = 0;
+    size_t filled_ = 0;
+    bool done_ = false;
+    bool failed_ = false;
+    bool stop_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable filled_cond_;
+    std::condition_variable free_cond_;
+    std::thread thread_;
+};
+
+} // namespace compiler
+} // namespace yuJson
+
+#endif // YUJSON_COMPILER_READER_HPP_
@@ -0,0 +1,39 @@
+#ifndef YUJSON_COMPILER_TOKEN_HPP_
+#define YUJSON_COMPILER_TOKEN_HPP_
+
+#include <string>
+
+namespace yuJson {
+namespace compiler {
+
+enum class TokenType {
+    kNone = 0,
+    kEof,
+    kNull,
+    kTrue,
+    kFalse,
+    kNumberInt,
+    kNumberFloat,
+    kString,
+    kLbrack,
+    kRbrack,
+    kLcurly,
+    kRcurly,
+    kComma,
+    kColon,
+    kMinus,
+};
+
+struct Token {
+    TokenType type{ TokenType::kNone };
+    std::string str{};
+    size_t offset{ 0 };
+    bool escaped{ false };  // kString only, str contains backslash escapes
+};
+
+constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::kMinus) + 1;
+
+} // namespace compiler
+} // namespace yuJson
+
+#endif // YUJSON_COMPILER_TOKEN_HPP_
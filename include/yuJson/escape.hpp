@@ -0,0 +1,124 @@
+#ifndef YUJSON_ESCAPE_HPP_
+#define YUJSON_ESCAPE_HPP_
+
+#include <cstddef>
+#include <cstring>
+
+namespace yuJson {
+
+// Accepts what Unescape writes and drops it, for checking escapes without decoding.
+struct NullSink {
+    void push_back(char /* c */) noexcept { }
+    void append(const char* /* str */, size_t /* size */) noexcept { }
+};
+
+/*
+* Decodes the body of a JSON string, the part between the quotes, and appends it to out.
+* \uXXXX escapes become UTF-8, a surrogate pair must be complete, unknown escapes are kept as written.
+* Returns false on a malformed \u escape, *error_index is then the offset of its backslash.
+*/
+template <typename Str>
+bool Unescape(const char* begin, const char* end, Str* out, size_t* error_index) {
+    auto read_hex = [&](const char** pos, int* hex) {
+        if (end - *pos < 4) {
+            return false;
+        }
+        int value = 0;
+        for (size_t i = 0; i < 4; i++) {
+            auto c = (*pos)[i];
+            if (c >= '0' && c <= '9') {
+                value = value * 16 + (c - '0');
+            }
+            else if (c >= 'a' && c <= 'f') {
+                value = value * 16 + (c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F') {
+                value = value * 16 + (c - 'A' + 10);
+            }
+            else {
+                return false;
+            }
+        }
+        *pos += 4;
+        *hex = value;
+        return true;
+    };
+
+    auto pos = begin;
+    while (pos < end) {
+        auto backslash = static_cast<const char*>(std::memchr(pos, '\\', end - pos));
+        if (!backslash) {
+            out->append(pos, end - pos);
+            break;
+        }
+        out->append(pos, backslash - pos);
+        pos = backslash + 1;
+        if (pos == end) {
+            out->push_back('\\');
+            break;
+        }
+        char c = *pos++;
+        switch (c) {
+        case '\"': case '/': case '\\': out->push_back(c); break;
+        case 'b': out->push_back('\b'); break;
+        case 'f': out->push_back('\f'); break;
+        case 'n': out->push_back('\n'); break;
+        case 'r': out->push_back('\r'); break;
+        case 't': out->push_back('\t'); break;
+        case 'u': {
+            *error_index = backslash - begin;
+            int hex_high;
+            if (!read_hex(&pos, &hex_high)) {
+                return false;
+            }
+            int codepoint;
+            if (hex_high >= 0xd800 && hex_high <= 0xdbff) {
+                if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+                    return false;
+                }
+                pos += 2;
+                int hex_low;
+                if (!read_hex(&pos, &hex_low)) {
+                    return false;
+                }
+                if (hex_low < 0xdc00 || hex_low > 0xdfff) {
+                    return false;
+                }
+                codepoint = 0x10000 + (hex_high - 0xD800) * 0x400 + (hex_low - 0xDC00);
+            }
+            else {
+                codepoint = hex_high;
+            }
+
+            if (codepoint >= 0x10000 && codepoint <= 0x10ffff) {
+                out->push_back(static_cast<char>(0xf0 | ((codepoint >> 18) & 0x07)));
+                out->push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f)));
+                out->push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+                out->push_back(static_cast<char>(0x80 | ((codepoint) & 0x3f)));
+            }
+            else if (codepoint >= 0x800 && codepoint <= 0xffff) {
+                out->push_back(static_cast<char>(0xe0 | ((codepoint >> 12) & 0x0f)));
+                out->push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+                out->push_back(static_cast<char>(0x80 | ((codepoint) & 0x3f)));
+            }
+            else if (codepoint >= 0x80 && codepoint <= 0x7ff) {
+                out->push_back(static_cast<char>(0xc0 | ((codepoint >> 6) & 0x1f)));
+                out->push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+            }
+            else {
+                out->push_back(static_cast<char>(codepoint));
+            }
+            break;
+        }
+        default:
+            out->push_back('\\');
+            out->push_back(c);
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace yuJson
+
+#endif // YUJSON_ESCAPE_HPP_
@@ -0,0 +1,423 @@
+#ifndef YUJSON_FROZEN_HPP_
+#define YUJSON_FROZEN_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <utility>
+
+#include <yuJson/value/value.hpp>
+
+namespace yuJson {
+
+class FrozenJson;
+
+// Read-only handle to a value inside a FrozenJson, cheap to copy. Missing members and indexes give an invalid value.
+class FrozenValue {
+public:
+    friend class FrozenJson;
+
+public:
+    FrozenValue() noexcept { }
+
+public:
+    bool IsValid() const noexcept {
+        return doc_ != nullptr;
+    }
+
+    value::ValueType Type() const noexcept;
+
+    bool IsNull() const noexcept { return IsValid() && Type() == value::ValueType::kNull; }
+    bool IsBoolean() const noexcept { return IsValid() && Type() == value::ValueType::kBoolean; }
+    bool IsNumber() const noexcept { return IsValid() && (Type() == value::ValueType::kNumberInt || Type() == value::ValueType::kNumberFloat); }
+    bool IsString() const noexcept { return IsValid() && Type() == value::ValueType::kString; }
+    bool IsArray() const noexcept { return IsValid() && Type() == value::ValueType::kArray; }
+    bool IsObject() const noexcept { return IsValid() && Type() == value::ValueType::kObject; }
+
+    bool Boolean() const;
+    int64_t Int() const;
+#ifndef YUJSON_DISABLE_FLOAT
+    double Float() const;
+#endif
+    // Points into the frozen buffer, valid as long as the FrozenJson.
+    StringView String() const;
+
+    // Elements of an array or members of an object.
+    size_t size() const noexcept;
+
+    FrozenValue operator[](size_t index) const noexcept;
+    FrozenValue operator[](int index) const noexcept {
+        return index < 0 ? FrozenValue() : operator[](static_cast<size_t>(index));
+    }
+
+    // Key of the index-th member of an object, members are in key order.
+    StringView KeyAt(size_t index) const noexcept;
+
+    // A Key carries its hash, so a lookup with it hashes nothing.
+    FrozenValue Find(const Key& key) const noexcept;
+    FrozenValue Find(StringView key) const noexcept {
+        return Find(Key(key));
+    }
+    FrozenValue Find(const char* key) const noexcept {
+        return Find(Key(StringView(key)));
+    }
+    FrozenValue operator[](StringView key) const noexcept {
+        return Find(Key(key));
+    }
+    FrozenValue operator[](const Key& key) const noexcept {
+        return Find(key);
+    }
+    FrozenValue operator[](const char* key) const noexcept {
+        return Find(Key(StringView(key)));
+    }
+
+private:
+    FrozenValue(const FrozenJson* doc, size_t index) noexcept : doc_(doc), index_(index) { }
+
+    auto GetNode() const noexcept;
+
+private:
+    const FrozenJson* doc_ = nullptr;
+    size_t index_ = 0;
+};
+
+/*
+* A finished document copied into one contiguous allocation, see Json::Freeze.
+* Containers keep their children next to each other, laid out depth first, strings sit in a shared pool.
+* Objects up to kLinearMembers members are scanned by cached key hash,
+* larger ones get an open addressing index of at most half load, so a lookup is O(1) either way.
+* Nothing changes after construction, concurrent reads need no locking.
+*/
+class FrozenJson {
+public:
+    friend class FrozenValue;
+
+    static constexpr uint32_t kLinearMembers = 8;
+    static constexpr size_t kMaxCount = UINT32_MAX;
+
+public:
+    FrozenJson() noexcept { }
+    ~FrozenJson() noexcept {
+        if (buffer_) {
+            resource_->Deallocate(buffer_, bytes_);
+        }
+    }
+
+    FrozenJson(FrozenJson&& other) noexcept {
+        operator=(std::move(other));
+    }
+
+    FrozenJson& operator=(FrozenJson&& other) noexcept {
+        std::swap(resource_, other.resource_);
+        std::swap(buffer_, other.buffer_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(nodes_, other.nodes_);
+        std::swap(objects_, other.objects_);
+        std::swap(keys_, other.keys_);
+        std::swap(slots_, other.slots_);
+        std::swap(key_chars_, other.key_chars_);
+        std::swap(chars_, other.chars_);
+        return *this;
+    }
+
+    FrozenJson(const FrozenJson&) = delete;
+    void operator=(const FrozenJson&) = delete;
+
+    // Copies the tree below root, the buffer comes from the default memory resource.
+    // Invalid when a count or offset does not fit the 32-bit fields, e.g. over 4 GiB of keys.
+    static FrozenJson Build(value::ValueInterface* root) {
+        FrozenJson frozen;
+        if (root) {
+            Builder builder;
+            if (builder.Run(root)) {
+                frozen.Assemble(builder);
+            }
+        }
+        return frozen;
+    }
+
+public:
+    FrozenValue Root() const noexcept {
+        return nodes_ ? FrozenValue(this, 0) : FrozenValue();
+    }
+
+    bool IsValid() const noexcept {
+        return nodes_ != nullptr;
+    }
+
+    // Size of the single allocation.
+    size_t Bytes() const noexcept {
+        return bytes_;
+    }
+
+private:
+    struct Node {
+        uint32_t type;
+        uint32_t size;          // string length or number of children
+        union {
+            bool boolean;
+            int64_t integer;
+            double floating;
+            uint64_t index;     // chars_ offset of a string, first child of an array, objects_ entry of an object
+        };
+    };
+
+    struct ObjectInfo {
+        uint32_t first;         // first child node
+        uint32_t keys;          // first KeyEntry
+        uint32_t slots;         // first index slot, unused below kLinearMembers
+        uint32_t mask;          // index slot count - 1, 0 without index
+    };
+
+    struct KeyEntry {
+        uint64_t hash;
+        uint32_t offset;        // into key_chars_
+        uint32_t size;
+    };
+
+    struct Builder {
+        std::vector<Node> nodes;
+        std::vector<ObjectInfo> objects;
+        std::vector<KeyEntry> keys;
+        std::vector<uint32_t> slots;    // member index + 1, 0 is empty
+        std::vector<char> key_chars;
+        std::vector<char> chars;
+        bool too_long = false;  // a string longer than Node::size holds
+
+        // False when a section outgrows the 32-bit sizes and offsets.
+        bool Run(value::ValueInterface* root) {
+            std::vector<std::pair<value::ValueInterface*, size_t>> pending;
+            nodes.push_back(Leaf(root));
+            pending.emplace_back(root, 0);
+            while (!pending.empty()) {
+                auto value = pending.back().first;
+                auto index = pending.back().second;
+                pending.pop_back();
+                auto first = nodes.size();
+                if (value->IsArray()) {
+                    auto& arr = value->GetArray().GetVector();
+                    nodes[index].index = first;
+                    for (auto& child : arr) {
+                        nodes.push_back(Leaf(child.get()));
+                    }
+                    // reversed, so the first child's subtree is laid out first
+                    for (size_t i = arr.size(); i-- > 0;) {
+                        pending.emplace_back(arr[i].get(), first + i);
+                    }
+                }
+                else if (value->IsObject()) {
+                    auto& map = value->GetObject().GetMap();
+                    if (map.size() > kMaxCount / 4) {
+                        // the index slot count, a power of two of at least twice the members, would not fit
+                        return false;
+                    }
+                    nodes[index].index = objects.size();
+                    ObjectInfo info{ static_cast<uint32_t>(first), static_cast<uint32_t>(keys.size()), 0, 0 };
+                    for (auto& member : map) {
+                        keys.push_back(KeyEntry{ Key::Hash(member.first.data(), member.first.size()),
+                            static_cast<uint32_t>(key_chars.size()), static_cast<uint32_t>(member.first.size()) });
+                        key_chars.insert(key_chars.end(), member.first.begin(), member.first.end());
+                        nodes.push_back(Leaf(member.second.get()));
+                    }
+                    if (map.size() > kLinearMembers) {
+                        uint32_t count = 1;
+                        while (count < map.size() * 2) {
+                            count <<= 1;
+                        }
+                        info.slots = static_cast<uint32_t>(slots.size());
+                        info.mask = count - 1;
+                        slots.resize(slots.size() + count, 0);
+                        for (uint32_t i = 0; i < map.size(); i++) {
+                            auto slot = keys[info.keys + i].hash & info.mask;
+                            while (slots[info.slots + slot] != 0) {
+                                slot = (slot + 1) & info.mask;
+                            }
+                            slots[info.slots + slot] = i + 1;
+                        }
+                    }
+                    objects.push_back(info);
+                    size_t i = map.size();
+                    for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
+                        pending.emplace_back(iter->second.get(), first + --i);
+                    }
+                }
+            }
+            // every index, offset and size stored in 32 bits is bounded by one of these
+            return !too_long && nodes.size() <= kMaxCount && keys.size() <= kMaxCount &&
+                slots.size() <= kMaxCount && key_chars.size() <= kMaxCount;
+        }
+
+        Node Leaf(value::ValueInterface* value) {
+            Node node;
+            node.type = static_cast<uint32_t>(value->Type());
+            node.size = 0;
+            node.index = 0;
+            switch (value->Type()) {
+            case value::ValueType::kBoolean:
+                node.boolean = value->GetBoolean().Get();
+                break;
+            case value::ValueType::kNumberInt:
+                node.integer = value->GetNumberInt().Get();
+                break;
+#ifndef YUJSON_DISABLE_FLOAT
+            case value::ValueType::kNumberFloat:
+                node.floating = value->GetNumberFloat().Get();
+                break;
+#endif
+            case value::ValueType::kString: {
+                auto& str = value->GetString().Get();
+                node.index = chars.size();
+                too_long = too_long || str.size() > kMaxCount;
+                node.size = static_cast<uint32_t>(str.size());
+                chars.insert(chars.end(), str.begin(), str.end());
+                break;
+            }
+            case value::ValueType::kArray:
+                node.size = static_cast<uint32_t>(value->GetArray().GetVector().size());
+                break;
+            case value::ValueType::kObject:
+                node.size = static_cast<uint32_t>(value->GetObject().GetMap().size());
+                break;
+            default:
+                break;
+            }
+            return node;
+        }
+    };
+
+    template <typename T>
+    static size_t SectionSize(const std::vector<T>& section) noexcept {
+        // every section starts 8 byte aligned
+        return (section.size() * sizeof(T) + 7) & ~size_t{ 7 };
+    }
+
+    template <typename T>
+    static const T* Copy(const std::vector<T>& section, char** pos) noexcept {
+        auto begin = reinterpret_cast<T*>(*pos);
+        if (!section.empty()) {
+            std::memcpy(begin, section.data(), section.size() * sizeof(T));
+        }
+        *pos += SectionSize(section);
+        return begin;
+    }
+
+    void Assemble(const Builder& builder) {
+        bytes_ = SectionSize(builder.nodes) + SectionSize(builder.objects) + SectionSize(builder.keys) +
+            SectionSize(builder.slots) + SectionSize(builder.key_chars) + SectionSize(builder.chars);
+        resource_ = GetDefaultResource();
+        buffer_ = static_cast<char*>(resource_->Allocate(bytes_));
+        auto pos = buffer_;
+        nodes_ = Copy(builder.nodes, &pos);
+        objects_ = Copy(builder.objects, &pos);
+        keys_ = Copy(builder.keys, &pos);
+        slots_ = Copy(builder.slots, &pos);
+        key_chars_ = Copy(builder.key_chars, &pos);
+        chars_ = Copy(builder.chars, &pos);
+    }
+
+private:
+    MemoryResource* resource_ = nullptr;
+    char* buffer_ = nullptr;
+    size_t bytes_ = 0;
+    const Node* nodes_ = nullptr;
+    const ObjectInfo* objects_ = nullptr;
+    const KeyEntry* keys_ = nullptr;
+    const uint32_t* slots_ = nullptr;
+    const char* key_chars_ = nullptr;
+    const char* chars_ = nullptr;
+};
+
+inline auto FrozenValue::GetNode() const noexcept {
+    return doc_->nodes_ + index_;
+}
+
+inline value::ValueType FrozenValue::Type() const noexcept {
+    return static_cast<value::ValueType>(GetNode()->type);
+}
+
+inline bool FrozenValue::Boolean() const {
+    if (!IsBoolean()) {
+        YUJSON_THROW(value::ValueTypeError("Not Boolean data"));
+    }
+    return GetNode()->boolean;
+}
+
+inline int64_t FrozenValue::Int() const {
+    if (!IsValid() || Type() != value::ValueType::kNumberInt) {
+        YUJSON_THROW(value::ValueTypeError("Not Number data"));
+    }
+    return GetNode()->integer;
+}
+
+#ifndef YUJSON_DISABLE_FLOAT
+inline double FrozenValue::Float() const {
+    if (!IsValid() || Type() != value::ValueType::kNumberFloat) {
+        YUJSON_THROW(value::ValueTypeError("Not Number data"));
+    }
+    return GetNode()->floating;
+}
+#endif
+
+inline StringView FrozenValue::String() const {
+    if (!IsString()) {
+        YUJSON_THROW(value::ValueTypeError("Not String data"));
+    }
+    return StringView(doc_->chars_ + GetNode()->index, GetNode()->size);
+}
+
+inline size_t FrozenValue::size() const noexcept {
+    if (!IsArray() && !IsObject()) {
+        return 0;
+    }
+    return GetNode()->size;
+}
+
+inline FrozenValue FrozenValue::operator[](size_t index) const noexcept {
+    if (index >= size()) {
+        return FrozenValue();
+    }
+    auto node = GetNode();
+    size_t first = Type() == value::ValueType::kArray ? node->index : doc_->objects_[node->index].first;
+    return FrozenValue(doc_, first + index);
+}
+
+inline StringView FrozenValue::KeyAt(size_t index) const noexcept {
+    if (!IsObject() || index >= size()) {
+        return StringView();
+    }
+    auto& entry = doc_->keys_[doc_->objects_[GetNode()->index].keys + index];
+    return StringView(doc_->key_chars_ + entry.offset, entry.size);
+}
+
+inline FrozenValue FrozenValue::Find(const Key& key) const noexcept {
+    if (!IsObject()) {
+        return FrozenValue();
+    }
+    auto node = GetNode();
+    auto& info = doc_->objects_[node->index];
+    auto keys = doc_->keys_ + info.keys;
+    auto match = [&](uint32_t i) {
+        return keys[i].hash == key.Hash() && keys[i].size == key.size() &&
+            std::memcmp(doc_->key_chars_ + keys[i].offset, key.View().data(), key.size()) == 0;
+    };
+    if (info.mask == 0) {
+        for (uint32_t i = 0; i < node->size; i++) {
+            if (match(i)) {
+                return FrozenValue(doc_, info.first + i);
+            }
+        }
+        return FrozenValue();
+    }
+    auto slots = doc_->slots_ + info.slots;
+    for (auto slot = key.Hash() & info.mask; slots[slot] != 0; slot = (slot + 1) & info.mask) {
+        if (match(slots[slot] - 1)) {
+            return FrozenValue(doc_, info.first + slots[slot] - 1);
+        }
+    }
+    return FrozenValue();
+}
+
+
+} // namespace yuJson
+
+#endif // YUJSON_FROZEN_HPP_
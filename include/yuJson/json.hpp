@@ -4,170 +4,292 @@
 // #define YUJSON_DISABLE_FLOAT
 
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <future>
+#include <chrono>
 #include <regex>
 #include <memory>
+#include <iterator>
+#include <type_traits>
 #include <initializer_list>
+#include <limits>
+#include <cmath>
 
 #include <yuJson/compiler/parser.hpp>
+#include <yuJson/compiler/parallel_parser.hpp>
 #include <yuJson/value/value.hpp>
+#include <yuJson/stats.hpp>
+#include <yuJson/optional.hpp>
+#include <yuJson/reclaimer.hpp>
+#include <yuJson/memory_usage.hpp>
+#include <yuJson/frozen.hpp>
+#include <yuJson/json_path.hpp>
+#include <yuJson/columnar.hpp>
+#include <yuJson/json_schema.hpp>
+#include <yuJson/stream_transformer.hpp>
+#include <yuJson/reformat.hpp>
 
 namespace yuJson {
+using compiler::ParseError;
+using compiler::ParseOptions;
+using compiler::ParseErrorString;
+using compiler::InputSource;
+using compiler::PipelinedReader;
+
+struct ParseResult;
+class JsonInit;
+
 class Json : private value::ValuePtr {
 public:
     using Base = value::ValuePtr;
 
 public:
-    class Iterator {
+    /*
+    * Walks an array or an object, *iter is the iterator itself so both key() and value() stay reachable.
+    * Increment and compare are O(1), begin() on a non container throws.
+    */
+    template <typename JsonT>
+    class BasicIterator {
     public:
         friend class Json;
+        template <typename> friend class BasicIterator;
+
+        using ArrayIter = typename std::conditional<std::is_const<JsonT>::value,
+            value::ValuePtrVector::const_iterator, value::ValuePtrVector::iterator>::type;
+        using ObjectIter = typename std::conditional<std::is_const<JsonT>::value,
+            value::ValuePtrtMap::const_iterator, value::ValuePtrtMap::iterator>::type;
+
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = BasicIterator;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const BasicIterator*;
+        using reference = const BasicIterator&;
+
     public:
-        Iterator(Json* base) {
-            base_ = base;
-            if (base) {
-                if (base_->IsArray()) {
-                    new(&arr_iter_) decltype(arr_iter_);
-                    arr_iter_ = (*base_)->ToArray().GetVector().begin();
-                }
-                else if (base_->IsObject()) {
-                    new(&obj_iter_) decltype(obj_iter_);
-                    obj_iter_ = (*base_)->ToObject().GetMap().begin();
-                }
-                else {
-                    throw value::ValueTypeError("Non container types cannot iterate");
-                }
-            }
-        }
-        Iterator(Json* base, const value::ValuePtrtMap::iterator& obj_iter) {
-            base_ = base;
-            new(&obj_iter_) decltype(obj_iter_);
-            obj_iter_ = obj_iter;
-        }
-        Iterator(Json* base, const value::ValuePtrVector::iterator& arr_iter) {
-            base_ = base;
-            new(&arr_iter_) decltype(arr_iter_);
-            arr_iter_ = arr_iter;
-        }
-        Iterator(const Iterator& other) noexcept {
-            operator=(other);
+        BasicIterator() noexcept { }
+        BasicIterator(const ArrayIter& arr_iter) noexcept : arr_iter_(arr_iter) { }
+        BasicIterator(const ObjectIter& obj_iter) noexcept : obj_iter_(obj_iter), is_object_(true) { }
+        // Iterator converts to ConstIterator
+        template <typename OtherJsonT, typename = typename std::enable_if<std::is_const<JsonT>::value && !std::is_const<OtherJsonT>::value>::type>
+        BasicIterator(const BasicIterator<OtherJsonT>& other) noexcept :
+            arr_iter_(other.arr_iter_), obj_iter_(other.obj_iter_), is_object_(other.is_object_) { }
+
+        bool operator==(const BasicIterator& other) const noexcept {
+            return is_object_ ? obj_iter_ == other.obj_iter_ : arr_iter_ == other.arr_iter_;
         }
 
-        template<class T>
-        void Destroy(T* ptr) {
-            ptr->~T();
+        bool operator!=(const BasicIterator& other) const noexcept {
+            return !operator==(other);
         }
 
-        ~Iterator() {
-            if (base_) {
-                if (base_->IsObject()) {
-                    Destroy(&obj_iter_);
-                }
-                else if (base_->IsArray()) {
-                    Destroy(&arr_iter_);
-                }
-            }
+        const BasicIterator& operator*() const noexcept {
+            return *this;
         }
-        void operator=(const Iterator& other) {
-            base_ = other.base_;
-            if (other.base_->IsObject()) {
-                new(&obj_iter_) decltype(obj_iter_);
-                obj_iter_ = other.obj_iter_;
-            }
-            else if (base_->IsArray()) {
-                new(&arr_iter_) decltype(arr_iter_);
-                arr_iter_ = other.arr_iter_;
-            }
-            else {
-                throw value::ValueTypeError("Non container types cannot iterate");
-            }
+
+        const BasicIterator* operator->() const noexcept {
+            return this;
         }
 
-        bool operator!=(const Iterator& other) const {
-            if (base_ == nullptr && other.base_ == nullptr) {
-                return false;
+        BasicIterator& operator++() noexcept {
+            if (is_object_) {
+                ++obj_iter_;
             }
-            if (other.base_ == nullptr || base_ == nullptr) {
-                return true;
-            }
-            if (base_->IsArray()) {
-                return (*base_)->ToArray().GetVector() == (*other.base_)->ToArray().GetVector();
-            }
-            else if (base_->IsObject()) {
-                return (*base_)->ToObject().GetMap() == (*other.base_)->ToObject().GetMap();
+            else {
+                ++arr_iter_;
             }
-            throw value::ValueTypeError("Non container types cannot iterate");
-        }
-
-        bool operator==(const Iterator& other) const {
-            return !operator!=(other);
+            return *this;
         }
 
-        Iterator& operator*() {
-            return *this;
+        BasicIterator operator++(int) noexcept {
+            auto prev = *this;
+            operator++();
+            return prev;
         }
 
-        const Iterator& operator++() {
-            if ((*base_)->Type() == value::ValueType::kArray) {
-                arr_iter_++;
-                if (arr_iter_ == (*base_)->ToArray().GetVector().end()) {
-                    base_ = nullptr;
-                }
+        BasicIterator& operator--() noexcept {
+            if (is_object_) {
+                --obj_iter_;
             }
-            else if ((*base_)->Type() == value::ValueType::kObject) {
-                obj_iter_++;
-                if (obj_iter_ == (*base_)->ToObject().GetMap().end()) {
-                    base_ = nullptr;
-                }
+            else {
+                --arr_iter_;
             }
             return *this;
         }
 
+        BasicIterator operator--(int) noexcept {
+            auto prev = *this;
+            operator--();
+            return prev;
+        }
+
     public:
         const std::string& key() const {
-            if ((*base_)->Type() == value::ValueType::kObject) {
+            if (is_object_) {
                 return obj_iter_->first;
             }
-            throw value::ValueTypeError("Not an object iterator");
+            YUJSON_THROW(value::ValueTypeError("Not an object iterator"));
         }
 
-        Json& value() {
-            if ((*base_)->Type() == value::ValueType::kArray) {
-                return static_cast<Json&>(*arr_iter_);
-            }
-            else if ((*base_)->Type() == value::ValueType::kObject) {
-                return static_cast<Json&>(obj_iter_->second);
+        JsonT& value() const noexcept {
+            if (is_object_) {
+                return static_cast<JsonT&>(obj_iter_->second);
             }
-            throw value::ValueTypeError("Non container types cannot iterate");
+            return static_cast<JsonT&>(*arr_iter_);
         }
 
     private:
-        union {
-            value::ValuePtrtMap::iterator obj_iter_;
-            value::ValuePtrVector::iterator arr_iter_;
-        };
-        Json* base_;
+        ArrayIter arr_iter_{};
+        ObjectIter obj_iter_{};
+        bool is_object_ = false;
+    };
+
+    using Iterator = BasicIterator<Json>;
+    using ConstIterator = BasicIterator<const Json>;
+    using iterator = Iterator;
+    using const_iterator = ConstIterator;
+
+    // Random access iterator over the elements of an array, see Elements().
+    template <typename JsonT>
+    class ElementIterator {
+    public:
+        template <typename> friend class ElementIterator;
+
+        using Ptr = typename std::conditional<std::is_const<JsonT>::value, const value::ValuePtr*, value::ValuePtr*>::type;
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Json;
+        using difference_type = std::ptrdiff_t;
+        using pointer = JsonT*;
+        using reference = JsonT&;
+
+    public:
+        ElementIterator() noexcept { }
+        explicit ElementIterator(Ptr ptr) noexcept : ptr_(ptr) { }
+        template <typename OtherJsonT, typename = typename std::enable_if<std::is_const<JsonT>::value && !std::is_const<OtherJsonT>::value>::type>
+        ElementIterator(const ElementIterator<OtherJsonT>& other) noexcept : ptr_(other.ptr_) { }
+
+        reference operator*() const noexcept { return static_cast<reference>(*ptr_); }
+        pointer operator->() const noexcept { return &static_cast<reference>(*ptr_); }
+        reference operator[](difference_type n) const noexcept { return static_cast<reference>(ptr_[n]); }
+
+        ElementIterator& operator++() noexcept { ++ptr_; return *this; }
+        ElementIterator operator++(int) noexcept { return ElementIterator(ptr_++); }
+        ElementIterator& operator--() noexcept { --ptr_; return *this; }
+        ElementIterator operator--(int) noexcept { return ElementIterator(ptr_--); }
+        ElementIterator& operator+=(difference_type n) noexcept { ptr_ += n; return *this; }
+        ElementIterator& operator-=(difference_type n) noexcept { ptr_ -= n; return *this; }
+        ElementIterator operator+(difference_type n) const noexcept { return ElementIterator(ptr_ + n); }
+        ElementIterator operator-(difference_type n) const noexcept { return ElementIterator(ptr_ - n); }
+        friend ElementIterator operator+(difference_type n, const ElementIterator& iter) noexcept { return iter + n; }
+        difference_type operator-(const ElementIterator& other) const noexcept { return ptr_ - other.ptr_; }
+
+        bool operator==(const ElementIterator& other) const noexcept { return ptr_ == other.ptr_; }
+        bool operator!=(const ElementIterator& other) const noexcept { return ptr_ != other.ptr_; }
+        bool operator<(const ElementIterator& other) const noexcept { return ptr_ < other.ptr_; }
+        bool operator>(const ElementIterator& other) const noexcept { return ptr_ > other.ptr_; }
+        bool operator<=(const ElementIterator& other) const noexcept { return ptr_ <= other.ptr_; }
+        bool operator>=(const ElementIterator& other) const noexcept { return ptr_ >= other.ptr_; }
+
+    private:
+        Ptr ptr_ = nullptr;
+    };
+
+    // What a MemberIterator points at, both fields refer into the object.
+    template <typename JsonT>
+    struct Member {
+        const std::string& key;
+        JsonT& value;
+    };
+
+    // Bidirectional iterator over the members of an object, see Members().
+    template <typename JsonT>
+    class MemberIterator {
+    public:
+        template <typename> friend class MemberIterator;
+
+        using MapIter = typename BasicIterator<JsonT>::ObjectIter;
+
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Member<JsonT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Member<JsonT>;
+
+    public:
+        MemberIterator() noexcept { }
+        explicit MemberIterator(const MapIter& iter) noexcept : iter_(iter) { }
+        template <typename OtherJsonT, typename = typename std::enable_if<std::is_const<JsonT>::value && !std::is_const<OtherJsonT>::value>::type>
+        MemberIterator(const MemberIterator<OtherJsonT>& other) noexcept : iter_(other.iter_) { }
+
+        reference operator*() const noexcept { return Member<JsonT>{ iter_->first, static_cast<JsonT&>(iter_->second) }; }
+
+        MemberIterator& operator++() noexcept { ++iter_; return *this; }
+        MemberIterator operator++(int) noexcept { return MemberIterator(iter_++); }
+        MemberIterator& operator--() noexcept { --iter_; return *this; }
+        MemberIterator operator--(int) noexcept { return MemberIterator(iter_--); }
+
+        bool operator==(const MemberIterator& other) const noexcept { return iter_ == other.iter_; }
+        bool operator!=(const MemberIterator& other) const noexcept { return iter_ != other.iter_; }
+
+    private:
+        MapIter iter_{};
+    };
+
+    // A [begin, end) pair that can be used in range-for, it does not own anything.
+    template <typename Iter>
+    class View {
+    public:
+        View(Iter begin, Iter end) noexcept : begin_(begin), end_(end) { }
+
+        Iter begin() const noexcept { return begin_; }
+        Iter end() const noexcept { return end_; }
+        size_t size() const noexcept { return std::distance(begin_, end_); }
+        bool empty() const noexcept { return begin_ == end_; }
+        // only for random access views
+        decltype(auto) operator[](size_t index) const noexcept { return begin_[index]; }
+
+    private:
+        Iter begin_;
+        Iter end_;
     };
 
+    using ElementView = View<ElementIterator<Json>>;
+    using ConstElementView = View<ElementIterator<const Json>>;
+    using MemberView = View<MemberIterator<Json>>;
+    using ConstMemberView = View<MemberIterator<const Json>>;
+
 public:
-    static Json Parse(const std::string& json_text) {
-        compiler::Lexer lexer(json_text);
-        compiler::Parser parser(&lexer);
-        return Json(parser.ParseValue());
+    // Returns an invalid Json on malformed input, use TryParse for the reason. Never throws on bad input.
+    // stats is only filled when built with YUJSON_ENABLE_STATS.
+    static Json Parse(const std::string& json_text, Stats* stats = nullptr) {
+        return Parse(json_text, ParseOptions{}, stats, nullptr, nullptr);
     }
-    static Json Object(std::initializer_list<Json> json_list = {}) {
-        Json json{ std::make_unique<value::ObjectValue>() };
-        for (auto iter = json_list.begin(); iter != json_list.end(); iter++, iter++) {
-            std::string key = (*iter)->ToString().Get();
-            json->ToObject().Set(key, std::move(static_cast<value::ValuePtr&>(*(const_cast<Json*>(iter) + 1))));
-        }
-        return json;
+    static Json Parse(const std::string& json_text, const ParseOptions& options, Stats* stats = nullptr) {
+        return Parse(json_text, options, stats, nullptr, nullptr);
     }
-    static Json Array(std::initializer_list<Json> json_list = {}) {
-        Json json{ std::make_unique<value::ArrayValue>() };
-        for (auto iter = json_list.begin(); iter != json_list.end(); iter++) {
-            json->ToArray().PushBack(std::move(static_cast<value::ValuePtr&>(const_cast<Json&>(*iter))));
+    static ParseResult TryParse(const std::string& json_text, Stats* stats = nullptr);
+    static ParseResult TryParse(const std::string& json_text, const ParseOptions& options, Stats* stats = nullptr);
+    // Parses while the input is still arriving, e.g. from a PipelinedReader over a file descriptor or a std::istream.
+    // A read error fails the parse with kReadFailed.
+    static Json Parse(InputSource* source, const ParseOptions& options = ParseOptions{}, Stats* stats = nullptr) {
+        compiler::Lexer lexer(source);
+        return Parse(&lexer, options, stats, nullptr, nullptr, source);
+    }
+    static ParseResult TryParse(InputSource* source, const ParseOptions& options = ParseOptions{}, Stats* stats = nullptr);
+    // Splits a large top-level array or object across thread_count threads (0 uses every hardware thread),
+    // input that cannot be split safely is parsed sequentially.
+    static Json ParseParallel(const std::string& json_text, size_t thread_count = 0) {
+        if (thread_count == 0) {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1u);
         }
-        return json;
+        compiler::ParallelParser parser(json_text, thread_count);
+        return Json(parser.ParseValue());
     }
+    // Elements given as rvalues are moved in, nested braces are built once and moved up.
+    static Json Object(std::initializer_list<JsonInit> json_list = {});
+    static Json Array(std::initializer_list<JsonInit> json_list = {});
 
 public:
     Json() noexcept { }
@@ -182,26 +304,9 @@ public:
 #endif
     Json(const char* str) : value::ValuePtr{ std::make_unique<value::StringValue>(str) } { }
     Json(const unsigned char* str) : value::ValuePtr{ std::make_unique<value::StringValue>((char*)str) } { }
-    Json(std::string str) : value::ValuePtr{ std::make_unique<value::StringValue>(str) } { }
-    Json(std::initializer_list<Json> json_list) {
-        if (json_list.size() % 2 == 0) {
-            bool is_obj = true;
-            for (auto iter = json_list.begin(); iter != json_list.end(); iter++, iter++) {
-                if (!(*iter)->IsString()) {
-                    is_obj = false;
-                    break;
-                }
-            }
-            if (is_obj) {
-                auto obj_json = Object(json_list);
-                *this = std::move(obj_json);
-            }
-        }
-        if (!IsValid()) {
-            auto arr_json = Array(json_list);
-            *this = std::move(arr_json);
-        }
-    }
+    Json(const std::string& str) : value::ValuePtr{ std::make_unique<value::StringValue>(str) } { }
+    Json(value::String&& str) : value::ValuePtr{ std::make_unique<value::StringValue>(std::move(str)) } { }
+    Json(std::initializer_list<JsonInit> json_list);
 
     ~Json() noexcept { }
 
@@ -212,15 +317,16 @@ public:
         this->reset(json.release());
     }
 
-    Json& operator[](const char* str) {
-        return static_cast<Json&>(GetValue().ToObject()[str]);
+    // Keys are looked up without building a std::string, pass a Key to also skip strlen.
+    Json& operator[](StringView key) {
+        return static_cast<Json&>(GetValue().ToObject()[key]);
     }
 
     Json& operator[](int index) {
         return static_cast<Json&>(GetValue().ToArray()[index]);
     }
 
-    Json& at(const char* key) {
+    Json& at(StringView key) {
         return static_cast<Json&>(GetValue().ToObject().At(key));
     }
 
@@ -232,42 +338,102 @@ public:
         GetValue().ToArray().PushBack(std::move(val));
     }
 
+    // Constructs the element from args at the end of an array, returns it.
+    template <typename... Args>
+    Json& emplace_back(Args&&... args) {
+        auto& arr = GetValue().ToArray();
+        arr.PushBack(Json(std::forward<Args>(args)...));
+        return static_cast<Json&>(arr.GetVector().back());
+    }
+
+    // Sets key of an object to the value constructed from args, returns it.
+    template <typename... Args>
+    Json& emplace(std::string key, Args&&... args) {
+        auto& slot = GetValue().ToObject().GetMap()[std::move(key)];
+        slot = Json(std::forward<Args>(args)...);
+        return static_cast<Json&>(slot);
+    }
+
+    // Only arrays have storage to reserve, objects are node based.
+    void reserve(size_t capacity) {
+        GetValue().ToArray().Reserve(capacity);
+    }
+
+    size_t capacity() const {
+        return GetValue().ToArray().Capacity();
+    }
+
     bool operator==(const Json& other) const {
-        if (GetValue().Type() != other->Type()) {
-            return false;
-        }
-        switch (GetValue().Type()) {
-        case value::ValueType::kNull:
-            return true;
-        case value::ValueType::kBoolean:
-            return GetValue().ToBoolean().Get() == other->ToBoolean().Get();
-        case value::ValueType::kNumberInt:
-            return GetValue().ToNumberInt().Get() == other->ToNumberInt().Get();
-#ifndef YUJSON_DISABLE_FLOAT
-        case value::ValueType::kNumberFloat:
-            return GetValue().ToNumberFloat().Get() == other->ToNumberFloat().Get();
-#endif
-        case value::ValueType::kString:
-            return GetValue().ToString().Get() == other->ToString().Get();
-        default:
-            return false;
+        if (!IsValid() || !other.IsValid()) {
+            return !IsValid() && !other.IsValid();
         }
+        return Equal(this->get(), other.get());
     }
 
     Iterator begin() {
-        return Iterator{ this };
+        if (IsArray()) {
+            return Iterator{ GetValue().GetArray().GetVector().begin() };
+        }
+        if (IsObject()) {
+            return Iterator{ GetValue().GetObject().GetMap().begin() };
+        }
+        YUJSON_THROW(value::ValueTypeError("Non container types cannot iterate"));
     }
 
     Iterator end() {
-        return Iterator{ nullptr };
+        if (IsArray()) {
+            return Iterator{ GetValue().GetArray().GetVector().end() };
+        }
+        if (IsObject()) {
+            return Iterator{ GetValue().GetObject().GetMap().end() };
+        }
+        return Iterator{};
     }
 
-    Iterator find(const char* key) {
-        auto map_iter = GetValue().ToObject().GetMap().find(key);
-        if (map_iter == GetValue().ToObject().GetMap().end()) {
-            return Iterator{ nullptr };
-        }
-        return Iterator{ this, map_iter };
+    ConstIterator begin() const {
+        return const_cast<Json*>(this)->begin();
+    }
+
+    ConstIterator end() const {
+        return const_cast<Json*>(this)->end();
+    }
+
+    ConstIterator cbegin() const {
+        return begin();
+    }
+
+    ConstIterator cend() const {
+        return end();
+    }
+
+    Iterator find(StringView key) {
+        return Iterator{ GetValue().ToObject().GetMap().find(key) };
+    }
+
+    ConstIterator find(StringView key) const {
+        return const_cast<Json*>(this)->find(key);
+    }
+
+    // Random access view of an array, throws on other types.
+    ElementView Elements() {
+        auto& vector = GetValue().ToArray().GetVector();
+        return ElementView{ ElementIterator<Json>{ vector.data() }, ElementIterator<Json>{ vector.data() + vector.size() } };
+    }
+
+    ConstElementView Elements() const {
+        auto& vector = GetValue().ToArray().GetVector();
+        return ConstElementView{ ElementIterator<const Json>{ vector.data() }, ElementIterator<const Json>{ vector.data() + vector.size() } };
+    }
+
+    // Key / value view of an object, throws on other types.
+    MemberView Members() {
+        auto& map = GetValue().ToObject().GetMap();
+        return MemberView{ MemberIterator<Json>{ map.begin() }, MemberIterator<Json>{ map.end() } };
+    }
+
+    ConstMemberView Members() const {
+        auto& map = GetValue().ToObject().GetMap();
+        return ConstMemberView{ MemberIterator<const Json>{ map.cbegin() }, MemberIterator<const Json>{ map.cend() } };
     }
 
     size_t size() const {
@@ -281,32 +447,365 @@ public:
             return String().size();
         }
         else {
-            throw value::ValueTypeError("Unable to view the type of size");
+            YUJSON_THROW(value::ValueTypeError("Unable to view the type of size"));
         }
     }
 
-    bool erase(const char* key) {
-        return GetValue().ToObject().GetMap().erase(key) != 0;
+    bool erase(StringView key) {
+        auto& map = GetValue().ToObject().GetMap();
+        auto iter = map.find(key);
+        if (iter == map.end()) {
+            return false;
+        }
+        map.erase(iter);
+        return true;
     }
 
     Iterator erase(const Iterator& iter) {
-        auto new_iter = GetValue().ToObject().GetMap().erase(iter.obj_iter_);
-        return Iterator{ this , new_iter };
+        if (iter.is_object_) {
+            return Iterator{ GetValue().ToObject().GetMap().erase(iter.obj_iter_) };
+        }
+        return Iterator{ GetValue().ToArray().GetVector().erase(iter.arr_iter_) };
+    }
+
+    /*
+    * JSON Patch (RFC 6902) and JSON Merge Patch (RFC 7396)
+    */
+    // Generates a patch that turns source into target.
+    // Identical subtrees produce no operations, arrays keep their common prefix and suffix.
+    static Json Diff(const Json& source, const Json& target) {
+        if (!source.IsValid() || !target.IsValid()) {
+            return Json{};
+        }
+        Json patch = Array();
+        std::string path;
+        Diff(source.get(), target.get(), &path, &patch);
+        return patch;
+    }
+
+    // Values are moved out of the patch into the document, only "copy" duplicates a subtree.
+    // Returns false on the first failing operation, the operations before it stay applied.
+    bool ApplyPatch(Json patch) {
+        if (!IsValid() || !patch.IsArray()) {
+            return false;
+        }
+        for (auto& op_ptr : patch->GetArray().GetVector()) {
+            if (!op_ptr->IsObject()) {
+                return false;
+            }
+            auto& op_map = op_ptr->GetObject().GetMap();
+            auto op_iter = op_map.find("op");
+            auto path_iter = op_map.find("path");
+            if (op_iter == op_map.end() || !op_iter->second->IsString() ||
+                path_iter == op_map.end() || !path_iter->second->IsString()) {
+                return false;
+            }
+            const auto& op = op_iter->second->GetString().Get();
+            std::vector<std::string> path;
+            if (!ParsePointer(path_iter->second->GetString().Get(), &path)) {
+                return false;
+            }
+
+            if (op == "remove") {
+                value::ValuePtr removed;
+                if (!PointerRemove(path, &removed)) {
+                    return false;
+                }
+                continue;
+            }
+            if (op == "move" || op == "copy") {
+                auto from_iter = op_map.find("from");
+                if (from_iter == op_map.end() || !from_iter->second->IsString()) {
+                    return false;
+                }
+                std::vector<std::string> from;
+                if (!ParsePointer(from_iter->second->GetString().Get(), &from)) {
+                    return false;
+                }
+                value::ValuePtr moved;
+                if (op == "copy") {
+                    auto source = PointerResolve(from, from.size());
+                    if (!source) {
+                        return false;
+                    }
+                    moved = Copy(source->get());
+                }
+                else {
+                    if (from == path) {
+                        continue;
+                    }
+                    if (from.size() < path.size() && std::equal(from.begin(), from.end(), path.begin())) {
+                        // a value cannot be moved into one of its children
+                        return false;
+                    }
+                    if (!PointerRemove(from, &moved)) {
+                        return false;
+                    }
+                }
+                if (!PointerAdd(path, std::move(moved))) {
+                    return false;
+                }
+                continue;
+            }
+
+            auto value_iter = op_map.find("value");
+            if (value_iter == op_map.end() || !value_iter->second) {
+                return false;
+            }
+            if (op == "add") {
+                if (!PointerAdd(path, std::move(value_iter->second))) {
+                    return false;
+                }
+            }
+            else if (op == "replace") {
+                if (!PointerReplace(path, std::move(value_iter->second))) {
+                    return false;
+                }
+            }
+            else if (op == "test") {
+                auto target = PointerResolve(path, path.size());
+                if (!target || !Equal(target->get(), value_iter->second.get())) {
+                    return false;
+                }
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ApplyMergePatch(Json patch) {
+        if (!patch.IsValid()) {
+            return;
+        }
+        MergePatch(this, std::move(patch));
+    }
+
+    /*
+    * Non-throwing accessors, empty on a type mismatch or missing path
+    */
+    Optional<bool> TryBoolean() const noexcept {
+        if (!IsBoolean()) return {};
+        return GetValue().GetBoolean().Get();
+    }
+
+    Optional<int64_t> TryInt() const noexcept {
+        if (!IsValid() || !GetValue().IsNumberInt()) return {};
+        return GetValue().GetNumberInt().Get();
+    }
+#ifndef YUJSON_DISABLE_FLOAT
+    Optional<double> TryFloat() const noexcept {
+        if (!IsValid()) return {};
+        if (GetValue().IsNumberFloat()) return GetValue().GetNumberFloat().Get();
+        if (GetValue().IsNumberInt()) return static_cast<double>(GetValue().GetNumberInt().Get());
+        return {};
+    }
+#endif
+    Optional<std::string> TryString() const {
+        if (!IsString()) return {};
+        const auto& str = GetValue().GetString().Get();
+        return std::string(str.data(), str.size());
+    }
+
+    // path is a JSON Pointer such as "/orders/0/id", returns nullptr when it does not resolve.
+    Json* TryGet(const std::string& path) {
+        std::vector<std::string> tokens;
+        if (!IsValid() || !ParsePointer(path, &tokens)) {
+            return nullptr;
+        }
+        return static_cast<Json*>(PointerResolve(tokens, tokens.size()));
+    }
+
+    const Json* TryGet(const std::string& path) const {
+        return const_cast<Json*>(this)->TryGet(path);
+    }
+
+    // Nodes matched by a compiled JSONPath, nothing is copied. Any change to the tree invalidates the pointers.
+    std::vector<Json*> Select(const JsonPath& path) {
+        std::vector<Json*> matches;
+        Select(path, &matches);
+        return matches;
+    }
+
+    std::vector<const Json*> Select(const JsonPath& path) const {
+        std::vector<const Json*> matches;
+        path.Run(const_cast<Json*>(this), [&matches](value::ValuePtr* slot) { matches.push_back(static_cast<const Json*>(slot)); });
+        return matches;
+    }
+
+    // Appends to matches, so a caller can keep one vector across queries.
+    void Select(const JsonPath& path, std::vector<Json*>* matches) {
+        path.Run(this, [matches](value::ValuePtr* slot) { matches->push_back(static_cast<Json*>(slot)); });
     }
 
     bool IsValid() const noexcept {
         return this->get() != nullptr;
     }
 
-    std::string Print(bool format = true) const {
+    // Detaches the tree and leaves freeing it to reclaimer, this becomes invalid.
+    // Scalars are freed in place, they are cheaper than a queue push.
+    void ReleaseAsync(Reclaimer* reclaimer = nullptr) {
+        if (!IsValid()) {
+            return;
+        }
+        if (!GetValue().IsArray() && !GetValue().IsObject()) {
+            this->reset();
+            return;
+        }
+        if (!reclaimer) {
+            reclaimer = DefaultReclaimer();
+        }
+        reclaimer->Reclaim(value::ValuePtr(this->release()));
+    }
+
+    // Copies the document into one read-only allocation for fast concurrent lookups, this stays as it is.
+    // Numbers kept as text are decoded, integers beyond the int64 range saturate.
+    // Invalid if the document is too large for the 32-bit offsets of the frozen layout.
+    FrozenJson Freeze() const {
+        return FrozenJson::Build(this->get());
+    }
+
+    // Pivots an array of objects into typed columns, see ColumnarTable. Anything else gives an invalid table.
+    ColumnarTable ToColumns() const {
+        return ColumnarTable::Build(this->get());
+    }
+
+    // Checks the document against a compiled schema, see JsonSchema::ValidateText for checking text before parsing it.
+    bool Validate(const JsonSchema& schema, SchemaError* error = nullptr) const {
+        return schema.Validate(this->get(), error);
+    }
+
+    // Walks the subtree without recursion, an invalid Json uses nothing.
+    yuJson::MemoryUsage MemoryUsage() const {
+        yuJson::MemoryUsage usage;
+        if (!IsValid()) {
+            return usage;
+        }
+        std::vector<value::ValueInterface*> pending{ this->get() };
+        while (!pending.empty()) {
+            auto value = pending.back();
+            pending.pop_back();
+            usage.values++;
+            usage.nodes += NodeSize(value) + value::ValueInterface::kNodeHeader;
+            switch (value->Type()) {
+            case value::ValueType::kNumberInt:
+                if (value->GetNumberInt().HasRaw()) {
+                    CountHeapString(static_cast<value::RawNumberIntValue&>(value->GetNumberInt()).GetRaw(), &usage.strings, &usage.slack);
+                }
+                break;
+#ifndef YUJSON_DISABLE_FLOAT
+            case value::ValueType::kNumberFloat:
+                if (value->GetNumberFloat().HasRaw()) {
+                    CountHeapString(static_cast<value::RawNumberFloatValue&>(value->GetNumberFloat()).GetRaw(), &usage.strings, &usage.slack);
+                }
+                break;
+#endif
+            case value::ValueType::kString:
+                CountHeapString(value->GetString().Raw(), &usage.strings, &usage.slack);
+                break;
+            case value::ValueType::kArray: {
+                auto& arr = value->GetArray().GetVector();
+                usage.elements += arr.size() * sizeof(value::ValuePtr);
+                usage.slack += (arr.capacity() - arr.size()) * sizeof(value::ValuePtr);
+                for (auto& child : arr) {
+                    pending.push_back(child.get());
+                }
+                break;
+            }
+            case value::ValueType::kObject: {
+                for (auto& member : value->GetObject().GetMap()) {
+                    usage.members += sizeof(value::ValuePtrtMap::value_type) + 4 * sizeof(void*);
+                    CountHeapString(member.first, &usage.keys, &usage.slack);
+                    pending.push_back(member.second.get());
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        return usage;
+    }
+
+    // Trims array storage and string capacity across the subtree, object keys are left as they are.
+    // Every trimmed buffer is reallocated, with a MonotonicResource that only grows the pool.
+    void ShrinkToFit() {
+        if (!IsValid()) {
+            return;
+        }
+        std::vector<value::ValueInterface*> pending{ this->get() };
+        while (!pending.empty()) {
+            auto value = pending.back();
+            pending.pop_back();
+            switch (value->Type()) {
+            case value::ValueType::kString: {
+                auto& str = value->GetString();
+                if (!str.IsRaw()) {
+                    str.GetMutable().shrink_to_fit();
+                }
+                break;
+            }
+            case value::ValueType::kArray: {
+                auto& arr = value->GetArray().GetVector();
+                arr.shrink_to_fit();
+                for (auto& child : arr) {
+                    pending.push_back(child.get());
+                }
+                break;
+            }
+            case value::ValueType::kObject: {
+                for (auto& member : value->GetObject().GetMap()) {
+                    pending.push_back(member.second.get());
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    std::string Print(bool format = true, Stats* stats = nullptr) const {
         if (!this->get()) {
             return "";
         }
         std::string jsonStr;
+#ifdef YUJSON_ENABLE_STATS
+        if (stats) {
+            auto begin = std::chrono::steady_clock::now();
+            Print(this->get(), format, 0, &jsonStr);
+            stats->print_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            stats->print_bytes += jsonStr.size();
+            return jsonStr;
+        }
+#else
+        (void)stats;
+#endif
         Print(this->get(), format, 0, &jsonStr);
         return jsonStr;
     }
 
+    // A large root, or a large array or object directly below it, is split into chunks that are serialized
+    // on thread_count threads, the output is byte-identical to Print(format). A thread_count of 0 uses
+    // every hardware thread.
+    std::string PrintParallel(bool format = true, size_t thread_count = 0) const {
+        if (!this->get()) {
+            return "";
+        }
+        if (thread_count == 0) {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        std::string jsonStr;
+        if (thread_count == 1) {
+            Print(this->get(), format, 0, &jsonStr);
+        }
+        else {
+            PrintParallel(this->get(), format, 0, thread_count, &jsonStr);
+        }
+        return jsonStr;
+    }
+
     bool IsNull() const noexcept {
         if (!IsValid()) return false;
         return GetValue().IsNull();
@@ -329,6 +828,21 @@ public:
     int64_t Int() const noexcept {
         return GetValue().ToNumberInt().Get();
     }
+
+    // Exact up to 2^64-1 for integers parsed with ParseOptions::lazy_numbers.
+    uint64_t Uint64() const noexcept {
+        return GetValue().ToNumberInt().GetUint64();
+    }
+
+    // The number as written in the input when parsed with lazy_numbers, otherwise as Print writes it.
+    std::string RawNumber() const {
+        if (!IsNumber()) {
+            YUJSON_THROW(value::ValueTypeError("Not Number data"));
+        }
+        std::string str;
+        AppendNumber(this->get(), &str);
+        return str;
+    }
 #ifndef YUJSON_DISABLE_FLOAT
     double Float() const noexcept {
         return GetValue().ToNumberFloat().Get();
@@ -341,7 +855,8 @@ public:
     }
 
     std::string String() const noexcept {
-        return GetValue().ToString().Get();
+        const auto& str = GetValue().ToString().Get();
+        return std::string(str.data(), str.size());
     }
 
     bool IsArray() const noexcept {
@@ -368,7 +883,7 @@ public:
         case value::ValueType::kString: {
             auto& str = GetValue().GetString().Get();
             if (str.empty() || str[0] < '0' && str[0] > '9') return 0;
-            return std::stoll(str);
+            return std::stoll(std::string(str.data(), str.size()));
         }
         case value::ValueType::kNull: {
             return defalut_int;
@@ -377,7 +892,7 @@ public:
             return GetValue().GetBoolean().Get() ? 1 : 0;
         }
         default: {
-            throw value::ValueTypeError("Object and Array cannot be converted to Int");
+            YUJSON_THROW(value::ValueTypeError("Object and Array cannot be converted to Int"));
         }
         }
     }
@@ -394,13 +909,13 @@ public:
         case value::ValueType::kString: {
             auto& str = GetValue().GetString().Get();
             if (str.empty() || str[0] < '0' && str[0] > '9') return 0;
-            return std::stod(str);
+            return std::stod(std::string(str.data(), str.size()));
         }
         case value::ValueType::kNull: {
             return default_float;
         }
         default: {
-            throw value::ValueTypeError("Object and Array cannot be converted to Float");
+            YUJSON_THROW(value::ValueTypeError("Object and Array cannot be converted to Float"));
         }
         }
     }
@@ -409,13 +924,11 @@ public:
     std::string ConvertToString(std::string default_str = "") const {
         if (!IsValid()) return default_str;
         switch (GetValue().Type()) {
-        case value::ValueType::kNumberInt: {
-            return std::to_string(GetValue().GetNumberInt().Get());
-        }
+        case value::ValueType::kNumberInt:
 #ifndef YUJSON_DISABLE_FLOAT
         case value::ValueType::kNumberFloat:
-            return std::to_string(GetValue().ToNumberFloat().Get());
-#endif    
+#endif
+            return RawNumber();
         case value::ValueType::kString: {
             return GetValue().GetString().Get().c_str();
         }
@@ -426,7 +939,7 @@ public:
             return GetValue().GetBoolean().Get() ? "true" : "false";
         }
         default: {
-            throw value::ValueTypeError("Object and Array cannot be converted to String");
+            YUJSON_THROW(value::ValueTypeError("Object and Array cannot be converted to String"));
         }
         }
     }
@@ -442,138 +955,943 @@ private:
     }
 
 private:
-    std::string StrEscape(const std::string& str) const {
-        std::string new_str;
-        bool escape = false;
-        for (auto c : str) {
-            if (escape) {
-                escape = false;
-                new_str += '\\';
-                if (c != '\\') {
-                    new_str += c;
+    static Json Parse(const std::string& json_text, const ParseOptions& options, Stats* stats,
+        compiler::ParseError* error, size_t* error_offset) {
+        compiler::Lexer lexer(json_text);
+        return Parse(&lexer, options, stats, error, error_offset);
+    }
+
+    static Json Parse(compiler::Lexer* lexer, const ParseOptions& options, Stats* stats,
+        compiler::ParseError* error, size_t* error_offset, InputSource* source = nullptr) {
+        compiler::Parser parser(lexer, options);
+        Json json;
+#ifdef YUJSON_ENABLE_STATS
+        if (stats) {
+            lexer->SetStats(stats);
+            parser.SetStats(stats);
+            auto begin = std::chrono::steady_clock::now();
+            json = Json(parser.Parse());
+            stats->parse_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            stats->parse_bytes += lexer->Offset();
+        }
+        else
+#else
+        (void)stats;
+#endif
+        {
+            json = Json(parser.Parse());
+        }
+        auto parse_error = parser.Error();
+        auto parse_error_offset = parser.ErrorOffset();
+        if (source && source->Failed()) {
+            // whatever was parsed is a truncated document
+            json = Json();
+            parse_error = ParseError::kReadFailed;
+            parse_error_offset = lexer->Offset();
+        }
+        if (error) {
+            *error = parse_error;
+            *error_offset = parse_error_offset;
+        }
+        return json;
+    }
+
+    // Walks both trees with an explicit stack, so the document depth does not touch the call stack.
+    static bool Equal(value::ValueInterface* a, value::ValueInterface* b) {
+        std::vector<std::pair<value::ValueInterface*, value::ValueInterface*>> pending{ { a, b } };
+        while (!pending.empty()) {
+            auto pair = pending.back();
+            pending.pop_back();
+            if (!EqualNode(pair.first, pair.second, &pending)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Compares a and b without their children, the pairs of children are left in pending.
+    static bool EqualNode(value::ValueInterface* a, value::ValueInterface* b,
+        std::vector<std::pair<value::ValueInterface*, value::ValueInterface*>>* pending) {
+        if (a == b) {
+            return true;
+        }
+        if (a->Type() != b->Type()) {
+            return false;
+        }
+        switch (a->Type()) {
+        case value::ValueType::kNull:
+            return true;
+        case value::ValueType::kBoolean:
+            return a->GetBoolean().Get() == b->GetBoolean().Get();
+        case value::ValueType::kNumberInt: {
+            int64_t num = a->GetNumberInt().Get();
+            if (num != b->GetNumberInt().Get()) {
+                return false;
+            }
+            // out of range input saturates, such numbers are only equal when written the same
+            return (num != std::numeric_limits<int64_t>::max() && num != std::numeric_limits<int64_t>::min()) ||
+                SameNumberText(a, b);
+        }
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat: {
+            double num = a->GetNumberFloat().Get();
+            if (num != b->GetNumberFloat().Get()) {
+                return false;
+            }
+            return !std::isinf(num) || SameNumberText(a, b);
+        }
+#endif
+        case value::ValueType::kString:
+            return a->GetString().Get() == b->GetString().Get();
+        case value::ValueType::kArray: {
+            const auto& a_arr = a->GetArray().GetVector();
+            const auto& b_arr = b->GetArray().GetVector();
+            if (a_arr.size() != b_arr.size()) {
+                return false;
+            }
+            // reversed, so the first elements are compared first
+            for (size_t i = a_arr.size(); i-- > 0;) {
+                pending->emplace_back(a_arr[i].get(), b_arr[i].get());
+            }
+            return true;
+        }
+        case value::ValueType::kObject: {
+            const auto& a_obj = a->GetObject().GetMap();
+            const auto& b_obj = b->GetObject().GetMap();
+            if (a_obj.size() != b_obj.size()) {
+                return false;
+            }
+            for (auto a_iter = a_obj.begin(), b_iter = b_obj.begin(); a_iter != a_obj.end(); a_iter++, b_iter++) {
+                if (a_iter->first != b_iter->first) {
+                    return false;
                 }
+                pending->emplace_back(a_iter->second.get(), b_iter->second.get());
             }
-            else if (c == '\\') {
-                escape = true;
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    // Like Equal, the subtree is walked with an explicit stack.
+    static value::ValuePtr Copy(value::ValueInterface* value) {
+        auto root = CopyNode(value);
+        std::vector<std::pair<value::ValueInterface*, value::ValueInterface*>> pending;
+        if (root && (root->IsArray() || root->IsObject())) {
+            pending.emplace_back(value, root.get());
+        }
+        while (!pending.empty()) {
+            auto source = pending.back().first;
+            auto copy = pending.back().second;
+            pending.pop_back();
+            if (source->IsArray()) {
+                auto& arr = copy->GetArray();
+                arr.Reserve(source->GetArray().GetVector().size());
+                for (auto& it : source->GetArray().GetVector()) {
+                    auto child = CopyNode(it.get());
+                    if (child->IsArray() || child->IsObject()) {
+                        pending.emplace_back(it.get(), child.get());
+                    }
+                    arr.PushBack(std::move(child));
+                }
             }
-            else if (c == '"') {
-                new_str += R"(\")";
+            else {
+                auto& obj = copy->GetObject();
+                for (auto& it : source->GetObject().GetMap()) {
+                    auto child = CopyNode(it.second.get());
+                    if (child->IsArray() || child->IsObject()) {
+                        pending.emplace_back(it.second.get(), child.get());
+                    }
+                    obj.Set(it.first, std::move(child));
+                }
             }
-            else if (c == '/') {
-                new_str += R"(\/")";
+        }
+        return root;
+    }
+
+    // A copy of a scalar, or an empty container of the same type.
+    static value::ValuePtr CopyNode(value::ValueInterface* value) {
+        switch (value->Type()) {
+        case value::ValueType::kNull:
+            return std::make_unique<value::NullValue>();
+        case value::ValueType::kBoolean:
+            return std::make_unique<value::BooleanValue>(value->GetBoolean().Get());
+        case value::ValueType::kNumberInt:
+            if (value->GetNumberInt().HasRaw()) {
+                return std::make_unique<value::RawNumberIntValue>(value->GetNumberInt().Raw());
             }
-            else if (c == '\b') {
-                new_str += R"(\b)";
+            return std::make_unique<value::NumberIntValue>(value->GetNumberInt().Get());
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            if (value->GetNumberFloat().HasRaw()) {
+                return std::make_unique<value::RawNumberFloatValue>(value->GetNumberFloat().Raw());
             }
-            else if (c == '\r') {
-                new_str += R"(\r)";
+            return std::make_unique<value::NumberFloatValue>(value->GetNumberFloat().Get());
+#endif
+        case value::ValueType::kString:
+            if (value->GetString().IsRaw()) {
+                return std::make_unique<value::RawStringValue>(StringView(value->GetString().Raw()), value->GetString().IsEscaped());
             }
-            else if (c == '\n') {
-                new_str += R"(\n)";
+            return std::make_unique<value::StringValue>(value->GetString().Get());
+        case value::ValueType::kArray:
+            return std::make_unique<value::ArrayValue>();
+        case value::ValueType::kObject:
+            return std::make_unique<value::ObjectValue>();
+        default:
+            return nullptr;
+        }
+    }
+
+private:
+    static void PushPatchOp(Json* patch, const char* op, const std::string& path, value::ValuePtr value = nullptr) {
+        Json op_json = Object();
+        op_json["op"] = op;
+        op_json["path"] = path;
+        if (value) {
+            op_json["value"] = Json{ std::move(value) };
+        }
+        patch->push_back(std::move(op_json));
+    }
+
+    static void AppendPointerToken(const std::string& token, std::string* path) {
+        *path += '/';
+        for (auto c : token) {
+            if (c == '~') {
+                *path += "~0";
             }
-            else if (c == '\t') {
-                new_str += R"(\t)";
+            else if (c == '/') {
+                *path += "~1";
             }
             else {
-                new_str += c;
+                *path += c;
             }
         }
-        return new_str;
     }
 
-    void Print(value::ValueInterface* value, bool format, size_t level, std::string* jsonStr) const {
-        std::string indent;
-        if (format) {
-            indent = std::string(level * kIndent, ' ');
+    struct DiffFrame {
+        value::ValueInterface* source;
+        value::ValueInterface* target;
+        size_t path_len;
+        // arrays: the elements in [next, common_end) are diffed pairwise, the rest is removed or added
+        size_t next;
+        size_t common_end;
+        size_t src_end;
+        size_t dst_end;
+        // objects: a merge pass over both ordered maps
+        value::ValuePtrtMap::iterator src_iter;
+        value::ValuePtrtMap::iterator dst_iter;
+    };
+
+    // The operations come out in the order of a depth-first walk, the walk itself uses an explicit stack.
+    static void Diff(value::ValueInterface* source, value::ValueInterface* target, std::string* path, Json* patch) {
+        std::vector<DiffFrame> stack;
+        DiffNode(source, target, path, patch, &stack);
+        while (!stack.empty()) {
+            auto& frame = stack.back();
+            path->resize(frame.path_len);
+            if (frame.source->IsArray()) {
+                const auto& src_arr = frame.source->GetArray().GetVector();
+                const auto& dst_arr = frame.target->GetArray().GetVector();
+                if (frame.next < frame.common_end) {
+                    size_t i = frame.next++;
+                    *path += '/' + std::to_string(i);
+                    // may grow the stack, frame is not used afterwards
+                    DiffNode(src_arr[i].get(), dst_arr[i].get(), path, patch, &stack);
+                    continue;
+                }
+                // remove from the back so that the indexes of the following operations stay valid
+                for (size_t i = frame.src_end; i > frame.common_end; i--) {
+                    *path += '/' + std::to_string(i - 1);
+                    PushPatchOp(patch, "remove", *path);
+                    path->resize(frame.path_len);
+                }
+                for (size_t i = frame.common_end; i < frame.dst_end; i++) {
+                    *path += '/' + std::to_string(i);
+                    PushPatchOp(patch, "add", *path, Copy(dst_arr[i].get()));
+                    path->resize(frame.path_len);
+                }
+                stack.pop_back();
+                continue;
+            }
+            auto src_end = frame.source->GetObject().GetMap().end();
+            auto dst_end = frame.target->GetObject().GetMap().end();
+            bool descended = false;
+            while (!descended && (frame.src_iter != src_end || frame.dst_iter != dst_end)) {
+                auto& src_iter = frame.src_iter;
+                auto& dst_iter = frame.dst_iter;
+                if (dst_iter == dst_end || (src_iter != src_end && src_iter->first < dst_iter->first)) {
+                    AppendPointerToken(src_iter->first, path);
+                    PushPatchOp(patch, "remove", *path);
+                    ++src_iter;
+                }
+                else if (src_iter == src_end || dst_iter->first < src_iter->first) {
+                    AppendPointerToken(dst_iter->first, path);
+                    PushPatchOp(patch, "add", *path, Copy(dst_iter->second.get()));
+                    ++dst_iter;
+                }
+                else {
+                    AppendPointerToken(src_iter->first, path);
+                    auto src_child = (src_iter++)->second.get();
+                    auto dst_child = (dst_iter++)->second.get();
+                    // may grow the stack, frame is not used afterwards
+                    DiffNode(src_child, dst_child, path, patch, &stack);
+                    descended = true;
+                    continue;
+                }
+                path->resize(frame.path_len);
+            }
+            if (!descended) {
+                stack.pop_back();
+            }
         }
+    }
 
-        switch (value->Type()) {
-        case value::ValueType::kNull: {
-            *jsonStr += "null";
-            break;
+    // Diffs two scalars right away, a pair of arrays or objects becomes a frame on the stack.
+    static void DiffNode(value::ValueInterface* source, value::ValueInterface* target, std::string* path, Json* patch,
+        std::vector<DiffFrame>* stack) {
+        if (source == target) {
+            return;
         }
-        case value::ValueType::kBoolean: {
-            *jsonStr += value->GetBoolean().Get() ? "true" : "false";
-            break;
+        if (source->Type() != target->Type()) {
+            PushPatchOp(patch, "replace", *path, Copy(target));
+            return;
         }
-        case value::ValueType::kNumberInt: {
-            auto str = std::to_string(value->GetNumberInt().Get());
-            *jsonStr += str;
+        switch (source->Type()) {
+        case value::ValueType::kArray: {
+            const auto& src_arr = source->GetArray().GetVector();
+            const auto& dst_arr = target->GetArray().GetVector();
+            size_t begin = 0;
+            while (begin < src_arr.size() && begin < dst_arr.size() &&
+                Equal(src_arr[begin].get(), dst_arr[begin].get())) {
+                ++begin;
+            }
+            size_t src_end = src_arr.size(), dst_end = dst_arr.size();
+            while (src_end > begin && dst_end > begin &&
+                Equal(src_arr[src_end - 1].get(), dst_arr[dst_end - 1].get())) {
+                --src_end;
+                --dst_end;
+            }
+            DiffFrame frame{ source, target, path->size(), begin, std::min(src_end, dst_end), src_end, dst_end, {}, {} };
+            stack->push_back(frame);
             break;
-        }value->GetNumberInt();
-#ifndef YUJSON_DISABLE_FLOAT
-        case value::ValueType::kNumberFloat: {
-            auto str = std::to_string(value->GetNumberFloat().Get());
-            *jsonStr += str;
+        }
+        case value::ValueType::kObject: {
+            auto& src_obj = source->GetObject().GetMap();
+            auto& dst_obj = target->GetObject().GetMap();
+            DiffFrame frame{ source, target, path->size(), 0, 0, 0, 0, src_obj.begin(), dst_obj.begin() };
+            stack->push_back(frame);
             break;
         }
-#endif 
-        case value::ValueType::kString: {
-            auto str = StrEscape(value->GetString().Get());
-            *jsonStr += "\"" + str + "\"";
+        default: {
+            if (!Equal(source, target)) {
+                PushPatchOp(patch, "replace", *path, Copy(target));
+            }
             break;
         }
-        case value::ValueType::kArray: {
-            *jsonStr += '[';
-            if (format) {
-                indent += std::string(kIndent, ' ');
+        }
+    }
+
+    template <typename Str>
+    static bool ParsePointer(const Str& pointer, std::vector<std::string>* tokens) {
+        if (pointer.empty()) {
+            return true;
+        }
+        if (pointer[0] != '/') {
+            return false;
+        }
+        for (size_t i = 0; i < pointer.size(); i++) {
+            char c = pointer[i];
+            if (c == '/') {
+                tokens->emplace_back();
             }
-            const auto& arr = value->GetArray().GetVector();
-            for (int i = 0; i < arr.size(); ) {
-                if (format) {
-                    *jsonStr += '\n' + indent;
+            else if (c == '~') {
+                if (++i == pointer.size()) {
+                    return false;
                 }
-                Print(arr[i].get(), format, level + 1, jsonStr);
-                if (++i < arr.size()) {
-                    *jsonStr += ", ";
+                if (pointer[i] == '0') {
+                    tokens->back() += '~';
                 }
+                else if (pointer[i] == '1') {
+                    tokens->back() += '/';
+                }
+                else {
+                    return false;
+                }
+            }
+            else {
+                tokens->back() += c;
             }
-            if (format) {
-                for (int i = 0; i < kIndent; i++) {
-                    indent.pop_back();
+        }
+        return true;
+    }
+
+    static bool ParsePointerIndex(const std::string& token, size_t* index) {
+        if (token.empty() || (token.size() > 1 && token[0] == '0')) {
+            return false;
+        }
+        size_t i = 0;
+        for (auto c : token) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            size_t digit = static_cast<size_t>(c - '0');
+            if (i > (std::numeric_limits<size_t>::max() - digit) / 10) {
+                return false;
+            }
+            i = i * 10 + digit;
+        }
+        *index = i;
+        return true;
+    }
+
+    // Resolves the first count tokens of path.
+    value::ValuePtr* PointerResolve(const std::vector<std::string>& path, size_t count) {
+        value::ValuePtr* cur = this;
+        for (size_t i = 0; i < count; i++) {
+            if ((*cur)->IsObject()) {
+                auto& obj = (*cur)->GetObject().GetMap();
+                auto iter = obj.find(path[i]);
+                if (iter == obj.end()) {
+                    return nullptr;
                 }
-                *jsonStr += '\n' + indent;
+                cur = &iter->second;
+            }
+            else if ((*cur)->IsArray()) {
+                auto& arr = (*cur)->GetArray().GetVector();
+                size_t index;
+                if (!ParsePointerIndex(path[i], &index) || index >= arr.size()) {
+                    return nullptr;
+                }
+                cur = &arr[index];
+            }
+            else {
+                return nullptr;
             }
-            *jsonStr += ']';
-            break;
         }
-        case value::ValueType::kObject: {
-            *jsonStr += '{';
-            if (format) {
-                indent += std::string(kIndent, ' ');
+        return cur;
+    }
+
+    bool PointerAdd(const std::vector<std::string>& path, value::ValuePtr value) {
+        if (path.empty()) {
+            this->reset(value.release());
+            return true;
+        }
+        auto parent = PointerResolve(path, path.size() - 1);
+        if (!parent) {
+            return false;
+        }
+        const auto& token = path.back();
+        if ((*parent)->IsObject()) {
+            (*parent)->GetObject().Set(token, std::move(value));
+            return true;
+        }
+        if ((*parent)->IsArray()) {
+            auto& arr = (*parent)->GetArray();
+            size_t index;
+            if (token == "-") {
+                arr.PushBack(std::move(value));
+                return true;
+            }
+            if (!ParsePointerIndex(token, &index) || index > arr.GetVector().size()) {
+                return false;
             }
+            arr.Insert(static_cast<int>(index), std::move(value));
+            return true;
+        }
+        return false;
+    }
 
-            const auto& obj = value->GetObject().GetMap();
-            int i = 0;
-            for (const auto& it : obj) {
-                if (format) {
-                    *jsonStr += '\n' + indent;
+    bool PointerRemove(const std::vector<std::string>& path, value::ValuePtr* removed) {
+        if (path.empty()) {
+            return false;
+        }
+        auto parent = PointerResolve(path, path.size() - 1);
+        if (!parent) {
+            return false;
+        }
+        const auto& token = path.back();
+        if ((*parent)->IsObject()) {
+            auto& obj = (*parent)->GetObject().GetMap();
+            auto iter = obj.find(token);
+            if (iter == obj.end()) {
+                return false;
+            }
+            *removed = std::move(iter->second);
+            obj.erase(iter);
+            return true;
+        }
+        if ((*parent)->IsArray()) {
+            auto& arr = (*parent)->GetArray();
+            size_t index;
+            if (!ParsePointerIndex(token, &index) || index >= arr.GetVector().size()) {
+                return false;
+            }
+            *removed = std::move(arr[static_cast<int>(index)]);
+            arr.Erase(static_cast<int>(index));
+            return true;
+        }
+        return false;
+    }
+
+    bool PointerReplace(const std::vector<std::string>& path, value::ValuePtr value) {
+        if (path.empty()) {
+            this->reset(value.release());
+            return true;
+        }
+        auto parent = PointerResolve(path, path.size() - 1);
+        if (!parent) {
+            return false;
+        }
+        const auto& token = path.back();
+        if ((*parent)->IsObject()) {
+            auto& obj = (*parent)->GetObject();
+            if (!obj.Exist(token)) {
+                return false;
+            }
+            obj.Set(token, std::move(value));
+            return true;
+        }
+        if ((*parent)->IsArray()) {
+            auto& arr = (*parent)->GetArray();
+            size_t index;
+            if (!ParsePointerIndex(token, &index) || index >= arr.GetVector().size()) {
+                return false;
+            }
+            arr.Set(static_cast<int>(index), std::move(value));
+            return true;
+        }
+        return false;
+    }
+
+    // Nested objects of the patch are merged from an explicit stack instead of recursing.
+    static void MergePatch(value::ValuePtr* target, value::ValuePtr patch) {
+        std::vector<std::pair<value::ValuePtr*, value::ValuePtr>> pending;
+        pending.emplace_back(target, std::move(patch));
+        while (!pending.empty()) {
+            auto slot = pending.back().first;
+            auto merge = std::move(pending.back().second);
+            pending.pop_back();
+            if (!merge->IsObject()) {
+                *slot = std::move(merge);
+                continue;
+            }
+            if (!*slot || !(*slot)->IsObject()) {
+                *slot = std::make_unique<value::ObjectValue>();
+            }
+            // map nodes do not move, so the member slots stay valid while they wait in pending
+            auto& target_obj = (*slot)->GetObject();
+            for (auto& it : merge->GetObject().GetMap()) {
+                if (it.second->IsNull()) {
+                    target_obj.Delete(it.first);
+                }
+                else if (it.second->IsObject()) {
+                    pending.emplace_back(&target_obj[it.first], std::move(it.second));
+                }
+                else {
+                    target_obj.Set(it.first, std::move(it.second));
+                }
+            }
+        }
+    }
+
+private:
+    static size_t NodeSize(value::ValueInterface* value) noexcept {
+        switch (value->Type()) {
+        case value::ValueType::kNull: return sizeof(value::NullValue);
+        case value::ValueType::kBoolean: return sizeof(value::BooleanValue);
+        case value::ValueType::kNumberInt:
+            return value->GetNumberInt().HasRaw() ? sizeof(value::RawNumberIntValue) : sizeof(value::NumberIntValue);
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            return value->GetNumberFloat().HasRaw() ? sizeof(value::RawNumberFloatValue) : sizeof(value::NumberFloatValue);
+#endif
+        case value::ValueType::kString: return sizeof(value::StringValue);
+        case value::ValueType::kArray: return sizeof(value::ArrayValue);
+        case value::ValueType::kObject: return sizeof(value::ObjectValue);
+        }
+        return 0;
+    }
+
+    // Strings short enough for the small string buffer own no heap block.
+    template <typename Str>
+    static void CountHeapString(const Str& str, size_t* used, size_t* slack) noexcept {
+        auto data = str.data();
+        auto self = reinterpret_cast<const char*>(&str);
+        if (data < self || data >= self + sizeof(str)) {
+            *used += str.size() + 1;
+            *slack += str.capacity() - str.size();
+        }
+    }
+
+    static bool SameNumberText(value::ValueInterface* a, value::ValueInterface* b) {
+        std::string a_text;
+        std::string b_text;
+        AppendNumber(a, &a_text);
+        AppendNumber(b, &b_text);
+        return a_text == b_text;
+    }
+
+    // Numbers that kept their input text are copied back as is, without formatting.
+    static void AppendNumber(value::ValueInterface* value, std::string* str) {
+        if (value->IsNumberInt()) {
+            auto& num = value->GetNumberInt();
+            if (num.HasRaw()) {
+                str->append(num.Raw().data(), num.Raw().size());
+            }
+            else {
+                *str += std::to_string(num.Get());
+            }
+            return;
+        }
+#ifndef YUJSON_DISABLE_FLOAT
+        auto& num = value->GetNumberFloat();
+        if (num.HasRaw()) {
+            str->append(num.Raw().data(), num.Raw().size());
+        }
+        else {
+            *str += std::to_string(num.Get());
+        }
+#endif
+    }
+
+    template <typename Str>
+    void StrEscape(const Str& str, std::string* jsonStr) const {
+        for (auto c : str) {
+            switch (c) {
+            case '"': *jsonStr += R"(\")"; break;
+            case '\\': *jsonStr += R"(\\)"; break;
+            case '/': *jsonStr += R"(\/)"; break;
+            case '\b': *jsonStr += R"(\b)"; break;
+            case '\f': *jsonStr += R"(\f)"; break;
+            case '\r': *jsonStr += R"(\r)"; break;
+            case '\n': *jsonStr += R"(\n)"; break;
+            case '\t': *jsonStr += R"(\t)"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char kHex[] = "0123456789abcdef";
+                    *jsonStr += R"(\u00)";
+                    *jsonStr += kHex[(c >> 4) & 0xf];
+                    *jsonStr += kHex[c & 0xf];
+                }
+                else {
+                    *jsonStr += c;
+                }
+                break;
+            }
+        }
+    }
+
+    // Walks the tree with an explicit stack, so the document depth does not touch the call stack.
+    void Print(value::ValueInterface* value, bool format, size_t level, std::string* jsonStr) const {
+        struct Frame {
+            value::ValueInterface* container;
+            size_t index;
+            value::ValuePtrtMap::iterator iter;
+        };
+        std::vector<Frame> stack;
+        std::string indent;
+        auto new_line = [&](size_t depth) {
+            if (!format) {
+                return;
+            }
+            size_t width = depth * kIndent;
+            if (indent.size() < width) {
+                indent.assign(width * 2, ' ');
+            }
+            *jsonStr += '\n';
+            jsonStr->append(indent.data(), width);
+        };
+        auto print_key = [&](const std::string& key) {
+            *jsonStr += '\"';
+            StrEscape(key, jsonStr);
+            *jsonStr += "\":";
+        };
+
+        do {
+            switch (value->Type()) {
+            case value::ValueType::kNull: {
+                *jsonStr += "null";
+                break;
+            }
+            case value::ValueType::kBoolean: {
+                *jsonStr += value->GetBoolean().Get() ? "true" : "false";
+                break;
+            }
+            case value::ValueType::kNumberInt:
+#ifndef YUJSON_DISABLE_FLOAT
+            case value::ValueType::kNumberFloat:
+#endif
+            {
+                AppendNumber(value, jsonStr);
+                break;
+            }
+            case value::ValueType::kString: {
+                *jsonStr += '\"';
+                auto& str = value->GetString();
+                if (str.IsRaw()) {
+                    // still the input text, it is already escaped
+                    jsonStr->append(str.Raw().data(), str.Raw().size());
                 }
-                auto key = StrEscape(it.first);
-                *jsonStr += '\"' + key + "\":";
+                else {
+                    StrEscape(str.Get(), jsonStr);
+                }
+                *jsonStr += '\"';
+                break;
+            }
+            case value::ValueType::kArray: {
+                *jsonStr += '[';
+                auto& arr = value->GetArray().GetVector();
+                if (!arr.empty()) {
+                    stack.push_back(Frame{ value, 0, {} });
+                    new_line(level + stack.size());
+                    value = arr[0].get();
+                    continue;
+                }
+                new_line(level + stack.size());
+                *jsonStr += ']';
+                break;
+            }
+            case value::ValueType::kObject: {
+                *jsonStr += '{';
+                auto& obj = value->GetObject().GetMap();
+                if (!obj.empty()) {
+                    stack.push_back(Frame{ value, 0, obj.begin() });
+                    new_line(level + stack.size());
+                    print_key(obj.begin()->first);
+                    value = obj.begin()->second.get();
+                    continue;
+                }
+                new_line(level + stack.size());
+                *jsonStr += '}';
+                break;
+            }
+            }
 
-                Print(it.second.get(), format, level + 1, jsonStr);
-                if (++i < obj.size()) {
-                    *jsonStr += ", ";
+            // the value is complete, move on to the next sibling or close the parents
+            value = nullptr;
+            while (!stack.empty()) {
+                auto& frame = stack.back();
+                if (frame.container->IsArray()) {
+                    auto& arr = frame.container->GetArray().GetVector();
+                    if (++frame.index < arr.size()) {
+                        *jsonStr += ", ";
+                        new_line(level + stack.size());
+                        value = arr[frame.index].get();
+                        break;
+                    }
+                    stack.pop_back();
+                    new_line(level + stack.size());
+                    *jsonStr += ']';
                 }
+                else {
+                    auto& obj = frame.container->GetObject().GetMap();
+                    if (++frame.iter != obj.end()) {
+                        *jsonStr += ", ";
+                        new_line(level + stack.size());
+                        print_key(frame.iter->first);
+                        value = frame.iter->second.get();
+                        break;
+                    }
+                    stack.pop_back();
+                    new_line(level + stack.size());
+                    *jsonStr += '}';
+                }
+            }
+        } while (value);
+    }
 
+    void PrintMember(const std::string* key, value::ValueInterface* value, bool last, bool format, size_t level,
+        const std::string& indent, size_t thread_count, std::string* jsonStr) const {
+        if (format) {
+            *jsonStr += '\n' + indent;
+        }
+        if (key) {
+            *jsonStr += '\"';
+            StrEscape(*key, jsonStr);
+            *jsonStr += "\":";
+        }
+        // only a child that splits itself goes parallel, anything else is printed without recursion
+        if (thread_count > 1 && ParallelPrintSize(value) >= kParallelPrintMinElements) {
+            PrintParallel(value, format, level + 1, thread_count, jsonStr);
+        }
+        else {
+            Print(value, format, level + 1, jsonStr);
+        }
+        if (!last) {
+            *jsonStr += ", ";
+        }
+    }
+
+    static size_t ParallelPrintSize(value::ValueInterface* value) noexcept {
+        if (value->IsArray()) {
+            return value->GetArray().GetVector().size();
+        }
+        if (value->IsObject()) {
+            return value->GetObject().GetMap().size();
+        }
+        return 0;
+    }
+
+    void PrintParallel(value::ValueInterface* value, bool format, size_t level, size_t thread_count, std::string* jsonStr) const {
+        if (!value->IsArray() && !value->IsObject()) {
+            Print(value, format, level, jsonStr);
+            return;
+        }
+        std::string indent;
+        if (format) {
+            indent = std::string((level + 1) * kIndent, ' ');
+        }
+        size_t size = ParallelPrintSize(value);
+        *jsonStr += value->IsArray() ? '[' : '{';
+
+        if (size < kParallelPrintMinElements) {
+            // not worth splitting, but a large child directly below may be
+            if (value->IsArray()) {
+                const auto& arr = value->GetArray().GetVector();
+                for (size_t i = 0; i < size; i++) {
+                    PrintMember(nullptr, arr[i].get(), i + 1 == size, format, level, indent, thread_count, jsonStr);
+                }
             }
-            if (format) {
-                for (int i = 0; i < 4; i++) {
-                    indent.pop_back();
+            else {
+                size_t i = 0;
+                for (const auto& it : value->GetObject().GetMap()) {
+                    PrintMember(&it.first, it.second.get(), ++i == size, format, level, indent, thread_count, jsonStr);
                 }
-                *jsonStr += '\n' + indent;
             }
-            *jsonStr += '}';
-            break;
         }
+        else {
+            size_t chunk_count = std::min(thread_count, size);
+            size_t chunk_size = (size + chunk_count - 1) / chunk_count;
+            std::vector<std::string> chunks(chunk_count);
+            auto print_chunk = [&](size_t chunk) {
+                size_t begin = chunk * chunk_size;
+                size_t end = std::min(begin + chunk_size, size);
+                auto* out = &chunks[chunk];
+                if (value->IsArray()) {
+                    const auto& arr = value->GetArray().GetVector();
+                    for (size_t i = begin; i < end; i++) {
+                        PrintMember(nullptr, arr[i].get(), i + 1 == size, format, level, indent, 1, out);
+                    }
+                }
+                else {
+                    auto iter = value->GetObject().GetMap().begin();
+                    std::advance(iter, begin);
+                    for (size_t i = begin; i < end; i++, iter++) {
+                        PrintMember(&iter->first, iter->second.get(), i + 1 == size, format, level, indent, 1, out);
+                    }
+                }
+            };
+            std::vector<std::future<void>> workers;
+            for (size_t chunk = 1; chunk < chunk_count; chunk++) {
+                workers.push_back(std::async(std::launch::async, print_chunk, chunk));
+            }
+            print_chunk(0);
+            for (auto& worker : workers) {
+                worker.get();
+            }
+            size_t total = jsonStr->size();
+            for (const auto& chunk : chunks) {
+                total += chunk.size();
+            }
+            jsonStr->reserve(total + indent.size() + 2);
+            for (const auto& chunk : chunks) {
+                *jsonStr += chunk;
+            }
         }
+
+        if (format) {
+            indent.resize(level * kIndent);
+            *jsonStr += '\n' + indent;
+        }
+        *jsonStr += value->IsArray() ? ']' : '}';
     }
 
 private:
     static constexpr size_t kIndent = 4;
+    static constexpr size_t kParallelPrintMinElements = 1024;
+};
+
+struct ParseResult {
+    Json json;
+    ParseError error = ParseError::kNone;
+    size_t offset = 0;      // byte offset of the offending token or character
+
+    explicit operator bool() const noexcept {
+        return error == ParseError::kNone;
+    }
+};
+
+// An element of a braced Json initializer. initializer_list only hands out const elements,
+// the Json is kept mutable so Array and Object can move it instead of copying the subtree.
+class JsonInit {
+public:
+    JsonInit() noexcept { }
+    template <typename T, typename = typename std::enable_if<std::is_convertible<T&&, Json>::value>::type>
+    JsonInit(T&& value) : json_(std::forward<T>(value)) { }
+    JsonInit(std::initializer_list<JsonInit> json_list) : json_(json_list) { }
+
+    Json& Get() const noexcept {
+        return json_;
+    }
+
+private:
+    mutable Json json_;
 };
 
+inline Json Json::Object(std::initializer_list<JsonInit> json_list) {
+    Json json{ std::make_unique<value::ObjectValue>() };
+    for (auto iter = json_list.begin(); iter != json_list.end(); iter++, iter++) {
+        const auto& key_str = iter->Get()->ToString().Get();
+        json->ToObject().Set(std::string(key_str.data(), key_str.size()), std::move((iter + 1)->Get()));
+    }
+    return json;
+}
+
+inline Json Json::Array(std::initializer_list<JsonInit> json_list) {
+    Json json{ std::make_unique<value::ArrayValue>() };
+    json->ToArray().Reserve(json_list.size());
+    for (auto& element : json_list) {
+        json->ToArray().PushBack(std::move(element.Get()));
+    }
+    return json;
+}
+
+inline Json::Json(std::initializer_list<JsonInit> json_list) {
+    if (json_list.size() % 2 == 0) {
+        bool is_obj = true;
+        for (auto iter = json_list.begin(); iter != json_list.end(); iter++, iter++) {
+            if (!iter->Get()->IsString()) {
+                is_obj = false;
+                break;
+            }
+        }
+        if (is_obj) {
+            *this = Object(json_list);
+        }
+    }
+    if (!IsValid()) {
+        *this = Array(json_list);
+    }
+}
+
+inline ParseResult Json::TryParse(const std::string& json_text, Stats* stats) {
+    return TryParse(json_text, ParseOptions{}, stats);
+}
+
+inline ParseResult Json::TryParse(const std::string& json_text, const ParseOptions& options, Stats* stats) {
+    ParseResult result;
+    result.json = Parse(json_text, options, stats, &result.error, &result.offset);
+    return result;
+}
+
+inline ParseResult Json::TryParse(InputSource* source, const ParseOptions& options, Stats* stats) {
+    ParseResult result;
+    compiler::Lexer lexer(source);
+    result.json = Parse(&lexer, options, stats, &result.error, &result.offset, source);
+    return result;
+}
+
 } // namespace yuJson
 
 #endif // YUJSON_JSON_HPP_
\ No newline at end of file
@@ -0,0 +1,889 @@
+#ifndef YUJSON_JSON_PATH_HPP_
+#define YUJSON_JSON_PATH_HPP_
+
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <yuJson/value/value.hpp>
+#include <yuJson/escape.hpp>
+
+namespace yuJson {
+
+/*
+* A JSONPath expression compiled once into a list of steps, run with Json::Select.
+* Supports $, .name, ['name'], .*, [*], .., [index] / [-index], [start:end:step], unions like [0,'a']
+* and filters [?(...)] over @ / $ paths of names and indexes, literals, == != < <= > >=, && || ! and parentheses.
+* A path without a comparison tests for existence.
+* Filters look at the values in place: numbers compare numerically, strings bytewise,
+* a missing operand only equals another missing one, arrays and objects are only equal to themselves.
+*/
+class JsonPath {
+public:
+    JsonPath() noexcept { }
+
+    // Returns an invalid path on a syntax error, ErrorOffset tells where.
+    static JsonPath Compile(StringView expression) {
+        JsonPath path;
+        Compiler compiler(expression, &path);
+        if (!compiler.Run()) {
+            path = JsonPath();
+            path.error_offset_ = compiler.ErrorOffset();
+            return path;
+        }
+        path.valid_ = true;
+        return path;
+    }
+
+public:
+    bool IsValid() const noexcept {
+        return valid_;
+    }
+
+    size_t ErrorOffset() const noexcept {
+        return error_offset_;
+    }
+
+    // Calls sink with the slot of every match, in the order the steps produce them.
+    template <typename Sink>
+    void Run(value::ValuePtr* root, Sink&& sink) const {
+        if (!valid_ || !root || !*root) {
+            return;
+        }
+        std::vector<value::ValuePtr*> current{ root };
+        std::vector<value::ValuePtr*> next;
+        std::vector<value::ValuePtr*> pending;
+        for (auto& step : steps_) {
+            next.clear();
+            for (auto slot : current) {
+                if (!step.descendant) {
+                    Apply(step, slot, root->get(), &next);
+                    continue;
+                }
+                // the node itself and then its descendants, in document order
+                pending.push_back(slot);
+                while (!pending.empty()) {
+                    auto node = pending.back();
+                    pending.pop_back();
+                    Apply(step, node, root->get(), &next);
+                    auto size = pending.size();
+                    ForEachChild(node->get(), [&](value::ValuePtr* child) { pending.push_back(child); });
+                    std::reverse(pending.begin() + size, pending.end());
+                }
+            }
+            current.swap(next);
+        }
+        for (auto slot : current) {
+            sink(slot);
+        }
+    }
+
+private:
+    enum class SelectorType {
+        kName,
+        kIndex,
+        kWildcard,
+        kSlice,
+        kFilter
+    };
+
+    struct Selector {
+        SelectorType type;
+        std::string name;
+        int64_t index = 0;          // kIndex, negative counts from the end
+        int64_t start = 0;          // kSlice
+        int64_t end = 0;
+        int64_t step = 1;
+        bool has_start = false;
+        bool has_end = false;
+        size_t filter = 0;          // root of the expression in nodes_
+    };
+
+    struct Step {
+        bool descendant = false;
+        std::vector<Selector> selectors;
+    };
+
+    // A name or an index of a path inside a filter.
+    struct Segment {
+        bool is_index;
+        std::string name;
+        int64_t index;
+    };
+
+    enum class OperandType {
+        kCurrent,
+        kRoot,
+        kNull,
+        kTrue,
+        kFalse,
+        kInt,
+        kFloat,
+        kString
+    };
+
+    struct Operand {
+        OperandType type;
+        size_t first = 0;           // paths: their segments in segments_
+        size_t count = 0;
+        int64_t int_value = 0;
+        double float_value = 0;
+        std::string str;
+    };
+
+    enum class Op {
+        kOr,
+        kAnd,
+        kNot,
+        kExists,
+        kEqual,
+        kNotEqual,
+        kLess,
+        kLessEqual,
+        kGreater,
+        kGreaterEqual
+    };
+
+    // Logical nodes refer to nodes_, kExists and the comparisons to operands_.
+    struct Node {
+        Op op;
+        size_t left = 0;
+        size_t right = 0;
+    };
+
+    // A resolved operand, either a value of the document or a literal.
+    struct Term {
+        enum Kind { kNothing, kNull, kBoolean, kNumber, kString, kContainer } kind = kNothing;
+        bool boolean = false;
+        bool is_int = false;
+        int64_t int_value = 0;
+        double float_value = 0;
+        StringView str;
+        value::ValueInterface* node = nullptr;
+    };
+
+private:
+    template <typename F>
+    static void ForEachChild(value::ValueInterface* node, F&& f) {
+        if (node->IsArray()) {
+            for (auto& child : node->GetArray().GetVector()) {
+                if (child) {
+                    f(&child);
+                }
+            }
+        }
+        else if (node->IsObject()) {
+            for (auto& member : node->GetObject().GetMap()) {
+                if (member.second) {
+                    f(&member.second);
+                }
+            }
+        }
+    }
+
+    // Position of a possibly negative index, false when it is out of range.
+    static bool NormalizeIndex(int64_t index, size_t size, size_t* position) noexcept {
+        auto len = static_cast<int64_t>(size);
+        if (index < 0) {
+            index += len;
+        }
+        if (index < 0 || index >= len) {
+            return false;
+        }
+        *position = static_cast<size_t>(index);
+        return true;
+    }
+
+    void Apply(const Step& step, value::ValuePtr* slot, value::ValueInterface* root, std::vector<value::ValuePtr*>* out) const {
+        auto node = slot->get();
+        for (auto& selector : step.selectors) {
+            switch (selector.type) {
+            case SelectorType::kName: {
+                if (node->IsObject()) {
+                    auto& map = node->GetObject().GetMap();
+                    auto iter = map.find(StringView(selector.name));
+                    if (iter != map.end() && iter->second) {
+                        out->push_back(&iter->second);
+                    }
+                }
+                break;
+            }
+            case SelectorType::kIndex: {
+                size_t position;
+                if (node->IsArray() && NormalizeIndex(selector.index, node->GetArray().GetVector().size(), &position)) {
+                    auto& child = node->GetArray().GetVector()[position];
+                    if (child) {
+                        out->push_back(&child);
+                    }
+                }
+                break;
+            }
+            case SelectorType::kWildcard: {
+                ForEachChild(node, [out](value::ValuePtr* child) { out->push_back(child); });
+                break;
+            }
+            case SelectorType::kSlice: {
+                if (node->IsArray()) {
+                    Slice(selector, &node->GetArray().GetVector(), out);
+                }
+                break;
+            }
+            case SelectorType::kFilter: {
+                ForEachChild(node, [&](value::ValuePtr* child) {
+                    if (Evaluate(selector.filter, child->get(), root)) {
+                        out->push_back(child);
+                    }
+                });
+                break;
+            }
+            }
+        }
+    }
+
+    // RFC 9535 slice semantics, a step of 0 selects nothing.
+    static void Slice(const Selector& selector, value::ValuePtrVector* vec, std::vector<value::ValuePtr*>* out) {
+        auto len = static_cast<int64_t>(vec->size());
+        auto step = selector.step;
+        if (step == 0) {
+            return;
+        }
+        auto normalize = [len](int64_t i) { return i >= 0 ? i : len + i; };
+        auto clamp = [](int64_t i, int64_t low, int64_t high) { return i < low ? low : (i > high ? high : i); };
+        auto push = [&](int64_t i) {
+            auto& child = (*vec)[static_cast<size_t>(i)];
+            if (child) {
+                out->push_back(&child);
+            }
+        };
+        if (step > 0) {
+            auto lower = clamp(selector.has_start ? normalize(selector.start) : 0, 0, len);
+            auto upper = clamp(selector.has_end ? normalize(selector.end) : len, 0, len);
+            // the bound is checked before stepping, a huge step would overflow i
+            for (auto i = lower; i < upper; i += step) {
+                push(i);
+                if (step >= upper - i) {
+                    break;
+                }
+            }
+        }
+        else {
+            auto upper = clamp(selector.has_start ? normalize(selector.start) : len - 1, -1, len - 1);
+            auto lower = clamp(selector.has_end ? normalize(selector.end) : -len - 1, -1, len - 1);
+            for (auto i = upper; lower < i; i += step) {
+                push(i);
+                if (step <= lower - i) {
+                    break;
+                }
+            }
+        }
+    }
+
+    bool Evaluate(size_t index, value::ValueInterface* current, value::ValueInterface* root) const {
+        auto& node = nodes_[index];
+        switch (node.op) {
+        case Op::kOr:
+            return Evaluate(node.left, current, root) || Evaluate(node.right, current, root);
+        case Op::kAnd:
+            return Evaluate(node.left, current, root) && Evaluate(node.right, current, root);
+        case Op::kNot:
+            return !Evaluate(node.left, current, root);
+        case Op::kExists:
+            return Resolve(operands_[node.left], current, root).kind != Term::kNothing;
+        default:
+            return Compare(node.op, Resolve(operands_[node.left], current, root), Resolve(operands_[node.right], current, root));
+        }
+    }
+
+    Term Resolve(const Operand& operand, value::ValueInterface* current, value::ValueInterface* root) const {
+        Term term;
+        switch (operand.type) {
+        case OperandType::kNull:
+            term.kind = Term::kNull;
+            return term;
+        case OperandType::kTrue:
+        case OperandType::kFalse:
+            term.kind = Term::kBoolean;
+            term.boolean = operand.type == OperandType::kTrue;
+            return term;
+        case OperandType::kInt:
+            term.kind = Term::kNumber;
+            term.is_int = true;
+            term.int_value = operand.int_value;
+            return term;
+        case OperandType::kFloat:
+            term.kind = Term::kNumber;
+            term.float_value = operand.float_value;
+            return term;
+        case OperandType::kString:
+            term.kind = Term::kString;
+            term.str = StringView(operand.str);
+            return term;
+        default:
+            break;
+        }
+
+        auto node = operand.type == OperandType::kCurrent ? current : root;
+        for (size_t i = operand.first; i < operand.first + operand.count && node; i++) {
+            auto& segment = segments_[i];
+            value::ValueInterface* child = nullptr;
+            if (segment.is_index) {
+                size_t position;
+                if (node->IsArray() && NormalizeIndex(segment.index, node->GetArray().GetVector().size(), &position)) {
+                    child = node->GetArray().GetVector()[position].get();
+                }
+            }
+            else if (node->IsObject()) {
+                auto& map = node->GetObject().GetMap();
+                auto iter = map.find(StringView(segment.name));
+                if (iter != map.end()) {
+                    child = iter->second.get();
+                }
+            }
+            node = child;
+        }
+        if (!node) {
+            return term;
+        }
+        switch (node->Type()) {
+        case value::ValueType::kNull:
+            term.kind = Term::kNull;
+            break;
+        case value::ValueType::kBoolean:
+            term.kind = Term::kBoolean;
+            term.boolean = node->GetBoolean().Get();
+            break;
+        case value::ValueType::kNumberInt:
+            term.kind = Term::kNumber;
+            term.is_int = true;
+            term.int_value = node->GetNumberInt().Get();
+            break;
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            term.kind = Term::kNumber;
+            term.float_value = node->GetNumberFloat().Get();
+            break;
+#endif
+        case value::ValueType::kString: {
+            auto& str = node->GetString().Get();
+            term.kind = Term::kString;
+            term.str = StringView(str.data(), str.size());
+            break;
+        }
+        default:
+            term.kind = Term::kContainer;
+            term.node = node;
+            break;
+        }
+        return term;
+    }
+
+    static bool Equal(const Term& a, const Term& b) noexcept {
+        if (a.kind != b.kind) {
+            return false;
+        }
+        switch (a.kind) {
+        case Term::kNothing:
+        case Term::kNull:
+            return true;
+        case Term::kBoolean:
+            return a.boolean == b.boolean;
+        case Term::kNumber:
+            if (a.is_int && b.is_int) {
+                return a.int_value == b.int_value;
+            }
+            return Number(a) == Number(b);
+        case Term::kString:
+            return a.str == b.str;
+        default:
+            return a.node == b.node;
+        }
+    }
+
+    static bool Less(const Term& a, const Term& b) noexcept {
+        if (a.kind == Term::kNumber && b.kind == Term::kNumber) {
+            if (a.is_int && b.is_int) {
+                return a.int_value < b.int_value;
+            }
+            return Number(a) < Number(b);
+        }
+        if (a.kind == Term::kString && b.kind == Term::kString) {
+            return a.str < b.str;
+        }
+        return false;
+    }
+
+    static double Number(const Term& term) noexcept {
+        return term.is_int ? static_cast<double>(term.int_value) : term.float_value;
+    }
+
+    static bool Compare(Op op, const Term& a, const Term& b) noexcept {
+        switch (op) {
+        case Op::kEqual: return Equal(a, b);
+        case Op::kNotEqual: return !Equal(a, b);
+        case Op::kLess: return Less(a, b);
+        case Op::kLessEqual: return Less(a, b) || (Equal(a, b) && Orderable(a));
+        case Op::kGreater: return Less(b, a);
+        case Op::kGreaterEqual: return Less(b, a) || (Equal(a, b) && Orderable(a));
+        default: return false;
+        }
+    }
+
+    static bool Orderable(const Term& term) noexcept {
+        return term.kind == Term::kNumber || term.kind == Term::kString;
+    }
+
+private:
+    // Recursive descent over the expression, fills the tables of path.
+    class Compiler {
+    public:
+        Compiler(StringView expression, JsonPath* path) noexcept : src_(expression), path_(path) { }
+
+    public:
+        bool Run() {
+            SkipSpace();
+            if (!Match('$')) {
+                return false;
+            }
+            while (true) {
+                SkipSpace();
+                if (pos_ == src_.size()) {
+                    return true;
+                }
+                if (!ParseSegment()) {
+                    return false;
+                }
+            }
+        }
+
+        size_t ErrorOffset() const noexcept {
+            return pos_;
+        }
+
+    private:
+        bool ParseSegment() {
+            Step step;
+            if (Match('.')) {
+                if (Match('.')) {
+                    step.descendant = true;
+                    if (Peek() == '[') {
+                        if (!ParseBracket(&step)) {
+                            return false;
+                        }
+                        path_->steps_.push_back(std::move(step));
+                        return true;
+                    }
+                }
+                Selector selector;
+                if (Match('*')) {
+                    selector.type = SelectorType::kWildcard;
+                }
+                else if (ParseName(&selector.name)) {
+                    selector.type = SelectorType::kName;
+                }
+                else {
+                    return false;
+                }
+                step.selectors.push_back(std::move(selector));
+            }
+            else if (Peek() == '[') {
+                if (!ParseBracket(&step)) {
+                    return false;
+                }
+            }
+            else {
+                return false;
+            }
+            path_->steps_.push_back(std::move(step));
+            return true;
+        }
+
+        bool ParseBracket(Step* step) {
+            Match('[');
+            do {
+                SkipSpace();
+                Selector selector;
+                if (!ParseSelector(&selector)) {
+                    return false;
+                }
+                step->selectors.push_back(std::move(selector));
+                SkipSpace();
+            } while (Match(','));
+            return Match(']');
+        }
+
+        bool ParseSelector(Selector* selector) {
+            char c = Peek();
+            if (c == '\'' || c == '\"') {
+                selector->type = SelectorType::kName;
+                return ParseQuoted(&selector->name);
+            }
+            if (Match('*')) {
+                selector->type = SelectorType::kWildcard;
+                return true;
+            }
+            if (Match('?')) {
+                selector->type = SelectorType::kFilter;
+                SkipSpace();
+                return ParseOr(&selector->filter, 0);
+            }
+            // index or slice
+            selector->has_start = ParseInt(&selector->start);
+            SkipSpace();
+            if (!Match(':')) {
+                if (!selector->has_start) {
+                    return false;
+                }
+                selector->type = SelectorType::kIndex;
+                selector->index = selector->start;
+                return true;
+            }
+            selector->type = SelectorType::kSlice;
+            SkipSpace();
+            selector->has_end = ParseInt(&selector->end);
+            SkipSpace();
+            if (Match(':')) {
+                SkipSpace();
+                ParseInt(&selector->step);
+            }
+            return true;
+        }
+
+        bool ParseOr(size_t* node, size_t depth) {
+            if (!ParseAnd(node, depth)) {
+                return false;
+            }
+            while (SkipSpace(), MatchStr("||")) {
+                SkipSpace();
+                size_t right;
+                if (!ParseAnd(&right, depth)) {
+                    return false;
+                }
+                *node = AddNode(Op::kOr, *node, right);
+            }
+            return true;
+        }
+
+        bool ParseAnd(size_t* node, size_t depth) {
+            if (!ParseUnary(node, depth)) {
+                return false;
+            }
+            while (SkipSpace(), MatchStr("&&")) {
+                SkipSpace();
+                size_t right;
+                if (!ParseUnary(&right, depth)) {
+                    return false;
+                }
+                *node = AddNode(Op::kAnd, *node, right);
+            }
+            return true;
+        }
+
+        bool ParseUnary(size_t* node, size_t depth) {
+            if (depth > kMaxFilterDepth) {
+                return false;
+            }
+            if (Match('!')) {
+                SkipSpace();
+                size_t operand;
+                if (!ParseUnary(&operand, depth + 1)) {
+                    return false;
+                }
+                *node = AddNode(Op::kNot, operand, 0);
+                return true;
+            }
+            if (Match('(')) {
+                SkipSpace();
+                if (!ParseOr(node, depth + 1)) {
+                    return false;
+                }
+                SkipSpace();
+                return Match(')');
+            }
+            return ParseComparison(node);
+        }
+
+        bool ParseComparison(size_t* node) {
+            size_t left;
+            if (!ParseOperand(&left)) {
+                return false;
+            }
+            SkipSpace();
+            Op op;
+            if (MatchStr("==")) op = Op::kEqual;
+            else if (MatchStr("!=")) op = Op::kNotEqual;
+            else if (MatchStr("<=")) op = Op::kLessEqual;
+            else if (MatchStr(">=")) op = Op::kGreaterEqual;
+            else if (Match('<')) op = Op::kLess;
+            else if (Match('>')) op = Op::kGreater;
+            else {
+                auto type = path_->operands_[left].type;
+                if (type != OperandType::kCurrent && type != OperandType::kRoot) {
+                    return false;
+                }
+                *node = AddNode(Op::kExists, left, 0);
+                return true;
+            }
+            SkipSpace();
+            size_t right;
+            if (!ParseOperand(&right)) {
+                return false;
+            }
+            *node = AddNode(op, left, right);
+            return true;
+        }
+
+        bool ParseOperand(size_t* index) {
+            Operand operand;
+            char c = Peek();
+            if (c == '@' || c == '$') {
+                ++pos_;
+                operand.type = c == '@' ? OperandType::kCurrent : OperandType::kRoot;
+                operand.first = path_->segments_.size();
+                if (!ParsePathSegments()) {
+                    return false;
+                }
+                operand.count = path_->segments_.size() - operand.first;
+            }
+            else if (c == '\'' || c == '\"') {
+                operand.type = OperandType::kString;
+                if (!ParseQuoted(&operand.str)) {
+                    return false;
+                }
+            }
+            else if (MatchStr("true")) {
+                operand.type = OperandType::kTrue;
+            }
+            else if (MatchStr("false")) {
+                operand.type = OperandType::kFalse;
+            }
+            else if (MatchStr("null")) {
+                operand.type = OperandType::kNull;
+            }
+            else if (!ParseNumber(&operand)) {
+                return false;
+            }
+            *index = path_->operands_.size();
+            path_->operands_.push_back(std::move(operand));
+            return true;
+        }
+
+        // .name and [index] / ['name'] after @ or $.
+        bool ParsePathSegments() {
+            while (true) {
+                Segment segment;
+                if (Match('.')) {
+                    segment.is_index = false;
+                    if (!ParseName(&segment.name)) {
+                        return false;
+                    }
+                }
+                else if (Match('[')) {
+                    SkipSpace();
+                    char c = Peek();
+                    if (c == '\'' || c == '\"') {
+                        segment.is_index = false;
+                        if (!ParseQuoted(&segment.name)) {
+                            return false;
+                        }
+                    }
+                    else {
+                        segment.is_index = true;
+                        if (!ParseInt(&segment.index)) {
+                            return false;
+                        }
+                    }
+                    SkipSpace();
+                    if (!Match(']')) {
+                        return false;
+                    }
+                }
+                else {
+                    return true;
+                }
+                path_->segments_.push_back(std::move(segment));
+            }
+        }
+
+        bool ParseNumber(Operand* operand) {
+            size_t begin = pos_;
+            Match('-');
+            size_t digits = pos_;
+            while (IsDigit(Peek())) {
+                ++pos_;
+            }
+            if (pos_ == digits) {
+                pos_ = begin;
+                return false;
+            }
+            bool is_float = false;
+            if (Peek() == '.') {
+                is_float = true;
+                ++pos_;
+                size_t fraction = pos_;
+                while (IsDigit(Peek())) {
+                    ++pos_;
+                }
+                if (pos_ == fraction) {
+                    return false;
+                }
+            }
+            if (Peek() == 'e' || Peek() == 'E') {
+                is_float = true;
+                ++pos_;
+                if (Peek() == '+' || Peek() == '-') {
+                    ++pos_;
+                }
+                size_t exponent = pos_;
+                while (IsDigit(Peek())) {
+                    ++pos_;
+                }
+                if (pos_ == exponent) {
+                    return false;
+                }
+            }
+            std::string text(src_.data() + begin, pos_ - begin);
+            if (!is_float) {
+                errno = 0;
+                auto num = std::strtoll(text.c_str(), nullptr, 10);
+                if (errno != ERANGE) {
+                    operand->type = OperandType::kInt;
+                    operand->int_value = static_cast<int64_t>(num);
+                    return true;
+                }
+            }
+            operand->type = OperandType::kFloat;
+            operand->float_value = std::strtod(text.c_str(), nullptr);
+            return true;
+        }
+
+        bool ParseInt(int64_t* value) {
+            size_t begin = pos_;
+            Match('-');
+            size_t digits = pos_;
+            while (IsDigit(Peek())) {
+                ++pos_;
+            }
+            if (pos_ == digits) {
+                pos_ = begin;
+                return false;
+            }
+            std::string text(src_.data() + begin, pos_ - begin);
+            errno = 0;
+            *value = static_cast<int64_t>(std::strtoll(text.c_str(), nullptr, 10));
+            if (errno == ERANGE) {
+                pos_ = begin;
+                return false;
+            }
+            return true;
+        }
+
+        // Letters, digits after the first character, '_' and any non-ASCII byte.
+        bool ParseName(std::string* name) {
+            size_t begin = pos_;
+            while (pos_ < src_.size()) {
+                auto c = static_cast<unsigned char>(src_[pos_]);
+                bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+                if (!alpha && !(pos_ > begin && IsDigit(c))) {
+                    break;
+                }
+                ++pos_;
+            }
+            name->assign(src_.data() + begin, pos_ - begin);
+            return pos_ > begin;
+        }
+
+        // 'name' or "name" with JSON escapes, plus \' inside single quotes.
+        bool ParseQuoted(std::string* str) {
+            char quote = src_[pos_++];
+            std::string escaped;
+            size_t begin = pos_;
+            while (pos_ < src_.size() && src_[pos_] != quote) {
+                if (src_[pos_] == '\\') {
+                    if (++pos_ == src_.size()) {
+                        break;
+                    }
+                    if (src_[pos_] == '\'') {
+                        ++pos_;
+                        escaped += '\'';
+                        continue;
+                    }
+                    escaped += '\\';
+                }
+                escaped += src_[pos_++];
+            }
+            if (!Match(quote)) {
+                return false;
+            }
+            size_t error_index;
+            str->clear();
+            if (!Unescape(escaped.data(), escaped.data() + escaped.size(), str, &error_index)) {
+                pos_ = begin;
+                return false;
+            }
+            return true;
+        }
+
+        size_t AddNode(Op op, size_t left, size_t right) {
+            Node node;
+            node.op = op;
+            node.left = left;
+            node.right = right;
+            path_->nodes_.push_back(node);
+            return path_->nodes_.size() - 1;
+        }
+
+        static bool IsDigit(char c) noexcept {
+            return c >= '0' && c <= '9';
+        }
+
+        char Peek() const noexcept {
+            return pos_ < src_.size() ? src_[pos_] : 0;
+        }
+
+        bool Match(char c) noexcept {
+            if (Peek() != c || pos_ == src_.size()) {
+                return false;
+            }
+            ++pos_;
+            return true;
+        }
+
+        bool MatchStr(const char* str) noexcept {
+            size_t len = strlen(str);
+            if (pos_ + len > src_.size() || memcmp(src_.data() + pos_, str, len) != 0) {
+                return false;
+            }
+            pos_ += len;
+            return true;
+        }
+
+        void SkipSpace() noexcept {
+            while (pos_ < src_.size() && (src_[pos_] == ' ' || src_[pos_] == '\t' || src_[pos_] == '\r' || src_[pos_] == '\n')) {
+                ++pos_;
+            }
+        }
+
+    private:
+        StringView src_;
+        JsonPath* path_;
+        size_t pos_ = 0;
+    };
+
+    static constexpr size_t kMaxFilterDepth = 64;
+
+private:
+    std::vector<Step> steps_;
+    std::vector<Node> nodes_;
+    std::vector<Operand> operands_;
+    std::vector<Segment> segments_;
+    bool valid_ = false;
+    size_t error_offset_ = 0;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_JSON_PATH_HPP_
@@ -0,0 +1,711 @@
+#ifndef YUJSON_JSON_SCHEMA_HPP_
+#define YUJSON_JSON_SCHEMA_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include <yuJson/pattern.hpp>
+#include <yuJson/value/value.hpp>
+#include <yuJson/compiler/parser.hpp>
+#include <yuJson/compiler/event_reader.hpp>
+
+namespace yuJson {
+
+// Why validation stopped. path is a JSON Pointer to the offending value, offset its position when text was validated.
+struct SchemaError {
+    const char* message = nullptr;
+    std::string path;
+    size_t offset = 0;
+};
+
+class SchemaValidator;
+
+/*
+* A JSON Schema (draft 2020-12) compiled into flat tables, see JsonSchema::ValidateText and Json::Validate.
+* Keywords: type, enum, const, minimum, maximum, exclusiveMinimum, exclusiveMaximum, minLength, maxLength, pattern,
+* items, minItems, maxItems, properties, required, additionalProperties, minProperties, maxProperties,
+* and the true / false schemas. Other keywords are ignored, enum and const only take scalars.
+* pattern uses the backtracking-free Pattern, so a long string cannot exhaust the stack or the time.
+*/
+class JsonSchema {
+public:
+    friend class SchemaValidator;
+
+public:
+    JsonSchema() noexcept { }
+
+    // Returns an invalid schema on malformed text or an unsupported keyword value, see ErrorPath.
+    static JsonSchema Compile(StringView schema_text) {
+        compiler::Lexer lexer(std::string(schema_text.data(), schema_text.size()));
+        compiler::Parser parser(&lexer);
+        auto schema = parser.Parse();
+        if (!schema) {
+            return JsonSchema();
+        }
+        return Compile(schema.get());
+    }
+
+    static JsonSchema Compile(value::ValueInterface* schema) {
+        JsonSchema compiled;
+        compiled.nodes_.resize(2);
+        compiled.nodes_[kFalseSchema].reject_all = true;
+        std::string path;
+        if (!schema || !compiled.CompileNode(schema, &path, &compiled.root_)) {
+            JsonSchema invalid;
+            invalid.error_path_ = std::move(path);
+            return invalid;
+        }
+        compiled.valid_ = true;
+        return compiled;
+    }
+
+public:
+    bool IsValid() const noexcept {
+        return valid_;
+    }
+
+    // JSON Pointer into the schema where compiling failed.
+    const std::string& ErrorPath() const noexcept {
+        return error_path_;
+    }
+
+    // Runs on the event stream of the lexer and stops at the first failure, no tree is built.
+    // Malformed text fails with the ParseError message.
+    bool ValidateText(StringView json_text, SchemaError* error = nullptr) const;
+
+    bool Validate(value::ValueInterface* value, SchemaError* error = nullptr) const;
+
+private:
+    enum TypeBits : uint8_t {
+        kNullBit = 1,
+        kBooleanBit = 2,
+        kIntegerBit = 4,
+        kNumberBit = 8,
+        kStringBit = 16,
+        kArrayBit = 32,
+        kObjectBit = 64,
+        kAnyType = 127
+    };
+
+    static constexpr uint32_t kTrueSchema = 0;
+    static constexpr uint32_t kFalseSchema = 1;
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+    struct Node {
+        bool reject_all = false;
+        uint8_t types = kAnyType;
+        bool has_minimum = false;
+        bool has_maximum = false;
+        bool has_exclusive_minimum = false;
+        bool has_exclusive_maximum = false;
+        double minimum = 0;
+        double maximum = 0;
+        double exclusive_minimum = 0;
+        double exclusive_maximum = 0;
+        size_t min_length = 0;
+        size_t max_length = kUnlimited;
+        uint32_t pattern = kNone;           // index into patterns_
+        uint32_t items = kTrueSchema;
+        size_t min_items = 0;
+        size_t max_items = kUnlimited;
+        uint32_t first_property = 0;        // range of properties_, sorted by name
+        uint32_t property_count = 0;
+        uint32_t first_required = 0;        // range of required_, sorted
+        uint32_t required_count = 0;
+        uint32_t additional = kTrueSchema;
+        size_t min_properties = 0;
+        size_t max_properties = kUnlimited;
+        uint32_t first_literal = 0;         // range of literals_ for enum / const
+        uint32_t literal_count = 0;
+        bool has_enum = false;
+    };
+
+    struct Property {
+        std::string name;
+        uint32_t schema;
+    };
+
+    struct Literal {
+        value::ValueType type;
+        bool boolean = false;
+        int64_t int_value = 0;
+        double float_value = 0;
+        std::string str;
+    };
+
+private:
+    bool CompileNode(value::ValueInterface* schema, std::string* path, uint32_t* index) {
+        if (schema->IsBoolean()) {
+            *index = schema->GetBoolean().Get() ? kTrueSchema : kFalseSchema;
+            return true;
+        }
+        if (!schema->IsObject()) {
+            return false;
+        }
+        *index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        // children are compiled first and append to the tables, so every range is filled in one go at the end
+        Node node;
+        std::vector<Property> properties;
+        std::vector<std::string> required;
+        std::vector<Literal> literals;
+        size_t path_size = path->size();
+        for (auto& member : schema->GetObject().GetMap()) {
+            auto& key = member.first;
+            auto keyword = member.second.get();
+            path->resize(path_size);
+            AppendPointerToken(key, path);
+            if (!keyword) {
+                return false;
+            }
+            if (key == "type") {
+                if (!CompileType(keyword, &node.types)) {
+                    return false;
+                }
+            }
+            else if (key == "enum" || key == "const") {
+                node.has_enum = true;
+                if (key == "const") {
+                    if (!AddLiteral(keyword, &literals)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (!keyword->IsArray()) {
+                    return false;
+                }
+                for (auto& entry : keyword->GetArray().GetVector()) {
+                    if (!entry || !AddLiteral(entry.get(), &literals)) {
+                        return false;
+                    }
+                }
+            }
+            else if (key == "minimum" || key == "maximum" || key == "exclusiveMinimum" || key == "exclusiveMaximum") {
+                double limit;
+                if (!ToNumber(keyword, &limit)) {
+                    return false;
+                }
+                if (key == "minimum") {
+                    node.has_minimum = true;
+                    node.minimum = limit;
+                }
+                else if (key == "maximum") {
+                    node.has_maximum = true;
+                    node.maximum = limit;
+                }
+                else if (key == "exclusiveMinimum") {
+                    node.has_exclusive_minimum = true;
+                    node.exclusive_minimum = limit;
+                }
+                else {
+                    node.has_exclusive_maximum = true;
+                    node.exclusive_maximum = limit;
+                }
+            }
+            else if (key == "minLength" || key == "maxLength" || key == "minItems" || key == "maxItems"
+                || key == "minProperties" || key == "maxProperties") {
+                size_t count;
+                if (!ToCount(keyword, &count)) {
+                    return false;
+                }
+                if (key == "minLength") node.min_length = count;
+                else if (key == "maxLength") node.max_length = count;
+                else if (key == "minItems") node.min_items = count;
+                else if (key == "maxItems") node.max_items = count;
+                else if (key == "minProperties") node.min_properties = count;
+                else node.max_properties = count;
+            }
+            else if (key == "pattern") {
+                if (!keyword->IsString() || !AddPattern(keyword->GetString().Get(), &node.pattern)) {
+                    return false;
+                }
+            }
+            else if (key == "items") {
+                if (!CompileNode(keyword, path, &node.items)) {
+                    return false;
+                }
+            }
+            else if (key == "additionalProperties") {
+                if (!CompileNode(keyword, path, &node.additional)) {
+                    return false;
+                }
+            }
+            else if (key == "properties") {
+                if (!keyword->IsObject()) {
+                    return false;
+                }
+                size_t properties_path = path->size();
+                for (auto& property : keyword->GetObject().GetMap()) {
+                    path->resize(properties_path);
+                    AppendPointerToken(property.first, path);
+                    uint32_t property_schema;
+                    if (!property.second || !CompileNode(property.second.get(), path, &property_schema)) {
+                        return false;
+                    }
+                    properties.push_back(Property{ property.first, property_schema });
+                }
+            }
+            else if (key == "required") {
+                if (!keyword->IsArray()) {
+                    return false;
+                }
+                for (auto& name : keyword->GetArray().GetVector()) {
+                    if (!name || !name->IsString()) {
+                        return false;
+                    }
+                    auto& str = name->GetString().Get();
+                    required.emplace_back(str.data(), str.size());
+                }
+            }
+        }
+        path->resize(path_size);
+
+        // the map hands out the properties in key order already
+        node.first_property = static_cast<uint32_t>(properties_.size());
+        node.property_count = static_cast<uint32_t>(properties.size());
+        std::move(properties.begin(), properties.end(), std::back_inserter(properties_));
+        std::sort(required.begin(), required.end());
+        required.erase(std::unique(required.begin(), required.end()), required.end());
+        node.first_required = static_cast<uint32_t>(required_.size());
+        node.required_count = static_cast<uint32_t>(required.size());
+        std::move(required.begin(), required.end(), std::back_inserter(required_));
+        node.first_literal = static_cast<uint32_t>(literals_.size());
+        node.literal_count = static_cast<uint32_t>(literals.size());
+        std::move(literals.begin(), literals.end(), std::back_inserter(literals_));
+        nodes_[*index] = node;
+        return true;
+    }
+
+    static bool CompileType(value::ValueInterface* keyword, uint8_t* types) {
+        auto bit = [](const value::String& name) -> uint8_t {
+            if (name == "null") return kNullBit;
+            if (name == "boolean") return kBooleanBit;
+            if (name == "integer") return kIntegerBit;
+            if (name == "number") return kNumberBit;
+            if (name == "string") return kStringBit;
+            if (name == "array") return kArrayBit;
+            if (name == "object") return kObjectBit;
+            return 0;
+        };
+        if (keyword->IsString()) {
+            *types = bit(keyword->GetString().Get());
+            return *types != 0;
+        }
+        if (!keyword->IsArray()) {
+            return false;
+        }
+        *types = 0;
+        for (auto& name : keyword->GetArray().GetVector()) {
+            uint8_t type_bit = name && name->IsString() ? bit(name->GetString().Get()) : 0;
+            if (!type_bit) {
+                return false;
+            }
+            *types |= type_bit;
+        }
+        return true;
+    }
+
+    static bool AddLiteral(value::ValueInterface* value, std::vector<Literal>* literals) {
+        Literal literal;
+        literal.type = value->Type();
+        switch (literal.type) {
+        case value::ValueType::kNull:
+            break;
+        case value::ValueType::kBoolean:
+            literal.boolean = value->GetBoolean().Get();
+            break;
+        case value::ValueType::kNumberInt:
+            literal.int_value = value->GetNumberInt().Get();
+            literal.float_value = static_cast<double>(literal.int_value);
+            break;
+#ifndef YUJSON_DISABLE_FLOAT
+        case value::ValueType::kNumberFloat:
+            literal.float_value = value->GetNumberFloat().Get();
+            break;
+#endif
+        case value::ValueType::kString: {
+            auto& str = value->GetString().Get();
+            literal.str.assign(str.data(), str.size());
+            break;
+        }
+        default:
+            return false;
+        }
+        literals->push_back(std::move(literal));
+        return true;
+    }
+
+    bool AddPattern(const value::String& pattern, uint32_t* index) {
+        patterns_.push_back(Pattern::Compile(StringView(pattern)));
+        if (!patterns_.back().IsValid()) {
+            return false;
+        }
+        *index = static_cast<uint32_t>(patterns_.size() - 1);
+        return true;
+    }
+
+    static bool ToNumber(value::ValueInterface* value, double* number) {
+        if (value->IsNumberInt()) {
+            *number = static_cast<double>(value->GetNumberInt().Get());
+            return true;
+        }
+#ifndef YUJSON_DISABLE_FLOAT
+        if (value->IsNumberFloat()) {
+            *number = value->GetNumberFloat().Get();
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    static bool ToCount(value::ValueInterface* value, size_t* count) {
+        double number;
+        if (!ToNumber(value, &number) || number < 0 || std::trunc(number) != number) {
+            return false;
+        }
+        // beyond size_t no count can reach it
+        *count = number >= static_cast<double>(kUnlimited) ? kUnlimited : static_cast<size_t>(number);
+        return true;
+    }
+
+    static void AppendPointerToken(const std::string& token, std::string* path) {
+        path->push_back('/');
+        for (auto c : token) {
+            if (c == '~') {
+                path->append("~0");
+            }
+            else if (c == '/') {
+                path->append("~1");
+            }
+            else {
+                path->push_back(c);
+            }
+        }
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<Property> properties_;
+    std::vector<std::string> required_;
+    std::vector<Literal> literals_;
+    std::vector<Pattern> patterns_;
+    uint32_t root_ = kTrueSchema;
+    bool valid_ = false;
+    std::string error_path_;
+};
+
+/*
+* Runs a JsonSchema as an EventReader handler, see compiler::EventReader and compiler::EmitEvents.
+* Keeps one frame per open container, the frames and the required bits are reused by the next document after Reset.
+*/
+class SchemaValidator {
+public:
+    explicit SchemaValidator(const JsonSchema* schema) noexcept : schema_(schema) { }
+
+public:
+    void Reset() noexcept {
+        depth_ = 0;
+        seen_.clear();
+        error_.message = nullptr;
+        error_.path.clear();
+        error_.offset = 0;
+    }
+
+    // The failure that stopped the events, message is nullptr when there was none.
+    const SchemaError& Error() const noexcept {
+        return error_;
+    }
+
+    bool Null() {
+        uint32_t index = JsonSchema::kTrueSchema;
+        return NextSchema(&index) && Check(index, JsonSchema::kNullBit) && CheckLiteral(index, value::ValueType::kNull, false, 0, 0, StringView());
+    }
+
+    bool Boolean(bool b) {
+        uint32_t index = JsonSchema::kTrueSchema;
+        return NextSchema(&index) && Check(index, JsonSchema::kBooleanBit) && CheckLiteral(index, value::ValueType::kBoolean, b, 0, 0, StringView());
+    }
+
+    bool Int(int64_t num) {
+        uint32_t index = JsonSchema::kTrueSchema;
+        return NextSchema(&index) && Check(index, JsonSchema::kIntegerBit | JsonSchema::kNumberBit)
+            && CheckLiteral(index, value::ValueType::kNumberInt, false, num, static_cast<double>(num), StringView())
+            && CheckNumber(index, static_cast<double>(num));
+    }
+
+    bool Float(double num) {
+        uint32_t index = JsonSchema::kTrueSchema;
+        // 1.0 counts as an integer, as in the specification
+        uint8_t bits = std::trunc(num) == num ? JsonSchema::kIntegerBit | JsonSchema::kNumberBit : JsonSchema::kNumberBit;
+        return NextSchema(&index) && Check(index, bits)
+            && CheckLiteral(index, value::ValueType::kNumberFloat, false, 0, num, StringView())
+            && CheckNumber(index, num);
+    }
+
+    bool String(StringView str) {
+        uint32_t index = JsonSchema::kTrueSchema;
+        if (!NextSchema(&index) || !Check(index, JsonSchema::kStringBit) || !CheckLiteral(index, value::ValueType::kString, false, 0, 0, str)) {
+            return false;
+        }
+        auto& node = schema_->nodes_[index];
+        if (node.min_length > 0 || node.max_length != JsonSchema::kUnlimited) {
+            // lengths are in code points, continuation bytes do not count
+            size_t length = 0;
+            for (auto c : str) {
+                length += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            }
+            if (length < node.min_length) {
+                return Fail("string too short", depth_);
+            }
+            if (length > node.max_length) {
+                return Fail("string too long", depth_);
+            }
+        }
+        if (node.pattern != JsonSchema::kNone && !schema_->patterns_[node.pattern].Search(str, &scratch_)) {
+            return Fail("string does not match the pattern", depth_);
+        }
+        return true;
+    }
+
+    bool StartArray() {
+        return Open(false);
+    }
+
+    bool EndArray() {
+        auto& frame = frames_[depth_ - 1];
+        if (frame.count < schema_->nodes_[frame.schema].min_items) {
+            return Fail("too few items", depth_ - 1);
+        }
+        --depth_;
+        return true;
+    }
+
+    bool StartObject() {
+        return Open(true);
+    }
+
+    bool Key(StringView key) {
+        auto& frame = frames_[depth_ - 1];
+        auto& node = schema_->nodes_[frame.schema];
+        frame.key.assign(key.data(), key.size());
+        // a repeated key is one property, as in the parsed document where the last value wins
+        bool limited = node.min_properties > 0 || node.max_properties != JsonSchema::kUnlimited;
+        if (limited && frame.names.insert(frame.key).second && ++frame.count > node.max_properties) {
+            return Fail("too many properties", depth_ - 1);
+        }
+        auto properties = schema_->properties_.begin() + node.first_property;
+        auto properties_end = properties + node.property_count;
+        auto property = std::lower_bound(properties, properties_end, key,
+            [](const JsonSchema::Property& a, StringView b) { return StringView(a.name) < b; });
+        if (property != properties_end && StringView(property->name) == key) {
+            frame.value_schema = property->schema;
+        }
+        else if (node.additional == JsonSchema::kFalseSchema) {
+            return Fail("additional property not allowed", depth_);
+        }
+        else {
+            frame.value_schema = node.additional;
+        }
+        auto required = schema_->required_.begin() + node.first_required;
+        auto required_end = required + node.required_count;
+        auto name = std::lower_bound(required, required_end, key,
+            [](const std::string& a, StringView b) { return StringView(a) < b; });
+        if (name != required_end && StringView(*name) == key) {
+            seen_[frame.seen + (name - required)] = 1;
+        }
+        return true;
+    }
+
+    bool EndObject() {
+        auto& frame = frames_[depth_ - 1];
+        auto& node = schema_->nodes_[frame.schema];
+        for (uint32_t i = 0; i < node.required_count; i++) {
+            if (!seen_[frame.seen + i]) {
+                // the path names the missing member
+                frame.key = schema_->required_[node.first_required + i];
+                return Fail("missing required property", depth_);
+            }
+        }
+        if (frame.count < node.min_properties) {
+            return Fail("too few properties", depth_ - 1);
+        }
+        seen_.resize(frame.seen);
+        --depth_;
+        return true;
+    }
+
+private:
+    struct Frame {
+        uint32_t schema;
+        bool is_object;
+        size_t count;
+        uint32_t value_schema;
+        size_t seen;            // offset of the required bits in seen_
+        std::string key;
+        std::unordered_set<std::string> names;  // keys so far, only kept under min/maxProperties
+    };
+
+    // Schema of the value that starts now.
+    bool NextSchema(uint32_t* index) {
+        if (depth_ == 0) {
+            *index = schema_->root_;
+            return true;
+        }
+        auto& frame = frames_[depth_ - 1];
+        if (frame.is_object) {
+            *index = frame.value_schema;
+            return true;
+        }
+        auto& node = schema_->nodes_[frame.schema];
+        if (++frame.count > node.max_items) {
+            return Fail("too many items", depth_ - 1);
+        }
+        *index = node.items;
+        return true;
+    }
+
+    bool Open(bool is_object) {
+        uint32_t index = JsonSchema::kTrueSchema;
+        if (!NextSchema(&index) || !Check(index, is_object ? JsonSchema::kObjectBit : JsonSchema::kArrayBit)) {
+            return false;
+        }
+        auto& node = schema_->nodes_[index];
+        if (node.has_enum) {
+            return Fail("value not in enum", depth_);
+        }
+        if (depth_ == frames_.size()) {
+            frames_.emplace_back();
+        }
+        auto& frame = frames_[depth_++];
+        frame.schema = index;
+        frame.is_object = is_object;
+        frame.count = 0;
+        frame.value_schema = JsonSchema::kTrueSchema;
+        frame.seen = seen_.size();
+        frame.names.clear();
+        if (is_object) {
+            seen_.resize(seen_.size() + node.required_count, 0);
+        }
+        return true;
+    }
+
+    bool Check(uint32_t index, uint8_t bits) {
+        auto& node = schema_->nodes_[index];
+        if (node.reject_all) {
+            return Fail("rejected by a false schema", depth_);
+        }
+        if (!(node.types & bits)) {
+            return Fail("type mismatch", depth_);
+        }
+        return true;
+    }
+
+    bool CheckLiteral(uint32_t index, value::ValueType type, bool boolean, int64_t int_value, double float_value, StringView str) {
+        auto& node = schema_->nodes_[index];
+        if (!node.has_enum) {
+            return true;
+        }
+        for (uint32_t i = 0; i < node.literal_count; i++) {
+            auto& literal = schema_->literals_[node.first_literal + i];
+            bool literal_number = literal.type == value::ValueType::kNumberInt || literal.type == value::ValueType::kNumberFloat;
+            bool number = type == value::ValueType::kNumberInt || type == value::ValueType::kNumberFloat;
+            if (number && literal_number) {
+                if (type == value::ValueType::kNumberInt && literal.type == value::ValueType::kNumberInt
+                    ? literal.int_value == int_value : literal.float_value == float_value) {
+                    return true;
+                }
+            }
+            else if (literal.type == type) {
+                if (type == value::ValueType::kNull
+                    || (type == value::ValueType::kBoolean && literal.boolean == boolean)
+                    || (type == value::ValueType::kString && StringView(literal.str) == str)) {
+                    return true;
+                }
+            }
+        }
+        return Fail("value not in enum", depth_);
+    }
+
+    bool CheckNumber(uint32_t index, double num) {
+        auto& node = schema_->nodes_[index];
+        if ((node.has_minimum && num < node.minimum) || (node.has_exclusive_minimum && num <= node.exclusive_minimum)) {
+            return Fail("number below the minimum", depth_);
+        }
+        if ((node.has_maximum && num > node.maximum) || (node.has_exclusive_maximum && num >= node.exclusive_maximum)) {
+            return Fail("number above the maximum", depth_);
+        }
+        return true;
+    }
+
+    // levels is the number of open containers the path goes through.
+    bool Fail(const char* message, size_t levels) {
+        error_.message = message;
+        error_.path.clear();
+        for (size_t i = 0; i < levels; i++) {
+            auto& frame = frames_[i];
+            if (frame.is_object) {
+                JsonSchema::AppendPointerToken(frame.key, &error_.path);
+            }
+            else {
+                error_.path += '/';
+                error_.path += std::to_string(frame.count - 1);
+            }
+        }
+        return false;
+    }
+
+private:
+    const JsonSchema* schema_;
+    std::vector<Frame> frames_;
+    size_t depth_ = 0;
+    std::vector<uint8_t> seen_;
+    Pattern::Scratch scratch_;
+    SchemaError error_;
+};
+
+inline bool JsonSchema::ValidateText(StringView json_text, SchemaError* error) const {
+    if (!valid_) {
+        return false;
+    }
+    compiler::Lexer lexer(std::string(json_text.data(), json_text.size()));
+    compiler::EventReader reader(&lexer);
+    SchemaValidator validator(this);
+    if (reader.Run(&validator)) {
+        return true;
+    }
+    if (error) {
+        if (reader.Error() == compiler::ParseError::kRejected) {
+            *error = validator.Error();
+        }
+        else {
+            error->message = compiler::ParseErrorString(reader.Error());
+            error->path.clear();
+        }
+        error->offset = reader.ErrorOffset();
+    }
+    return false;
+}
+
+inline bool JsonSchema::Validate(value::ValueInterface* value, SchemaError* error) const {
+    if (!valid_ || !value) {
+        return false;
+    }
+    SchemaValidator validator(this);
+    if (compiler::EmitEvents(value, &validator)) {
+        return true;
+    }
+    if (error) {
+        *error = validator.Error();
+    }
+    return false;
+}
+
+} // namespace yuJson
+
+#endif // YUJSON_JSON_SCHEMA_HPP_
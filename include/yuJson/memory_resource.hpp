@@ -0,0 +1,218 @@
+#ifndef YUJSON_MEMORY_RESOURCE_HPP_
+#define YUJSON_MEMORY_RESOURCE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace yuJson {
+
+/*
+* A C++14 stand-in for std::pmr::memory_resource.
+* Value nodes, array storage, object nodes and string payloads are allocated from
+* the default resource of the thread that creates them, see MemoryResourceScope.
+* Every block remembers its resource, so it can be freed from any thread.
+*
+* Limits:
+* - Object keys are std::string, a key too long for the small string buffer is still
+*   allocated from the global heap. Only the map node holding it comes from the resource.
+* - The resource is picked from a thread_local slot when a value is created, a value built
+*   on another thread, or outside the scope, goes to that thread's default resource.
+* - Each value node carries a header of alignof(std::max_align_t) bytes, 16 on common
+*   64-bit targets, that records its resource.
+*/
+class MemoryResource {
+public:
+    virtual ~MemoryResource() noexcept { }
+
+public:
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return DoAllocate(bytes, alignment);
+    }
+
+    void Deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+        DoDeallocate(ptr, bytes, alignment);
+    }
+
+protected:
+    virtual void* DoAllocate(size_t bytes, size_t alignment) = 0;
+    virtual void DoDeallocate(void* ptr, size_t bytes, size_t alignment) noexcept = 0;
+};
+
+class NewDeleteResource : public MemoryResource {
+protected:
+    // operator new already aligns to max_align_t, which is all the values ask for
+    void* DoAllocate(size_t bytes, size_t /* alignment */) override {
+        return ::operator new(bytes);
+    }
+
+    void DoDeallocate(void* ptr, size_t /* bytes */, size_t /* alignment */) noexcept override {
+        ::operator delete(ptr);
+    }
+};
+
+inline MemoryResource* GetNewDeleteResource() noexcept {
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+inline MemoryResource*& DefaultResourceSlot() noexcept {
+    static thread_local MemoryResource* resource = GetNewDeleteResource();
+    return resource;
+}
+
+inline MemoryResource* GetDefaultResource() noexcept {
+    return DefaultResourceSlot();
+}
+
+// Returns the previous default resource of the calling thread.
+inline MemoryResource* SetDefaultResource(MemoryResource* resource) noexcept {
+    auto& slot = DefaultResourceSlot();
+    auto prev = slot;
+    slot = resource ? resource : GetNewDeleteResource();
+    return prev;
+}
+
+// Routes every value created on this thread to resource until the scope ends.
+class MemoryResourceScope {
+public:
+    explicit MemoryResourceScope(MemoryResource* resource) noexcept : prev_(SetDefaultResource(resource)) { }
+    ~MemoryResourceScope() noexcept {
+        SetDefaultResource(prev_);
+    }
+
+    MemoryResourceScope(const MemoryResourceScope&) = delete;
+    void operator=(const MemoryResourceScope&) = delete;
+
+private:
+    MemoryResource* prev_;
+};
+
+/*
+* Bump allocator over chunks taken from upstream, like std::pmr::monotonic_buffer_resource.
+* Deallocate is a no-op, everything is returned at once by Release or the destructor,
+* so every Json allocated from it must be destroyed first. Not thread-safe.
+*/
+class MonotonicResource : public MemoryResource {
+public:
+    explicit MonotonicResource(size_t initial_size = 4096, MemoryResource* upstream = GetNewDeleteResource()) noexcept :
+        upstream_(upstream), initial_size_(std::max(initial_size, size_t{ 64 })), next_size_(initial_size_) { }
+    ~MonotonicResource() noexcept {
+        Release();
+    }
+
+    MonotonicResource(const MonotonicResource&) = delete;
+    void operator=(const MonotonicResource&) = delete;
+
+    void Release() noexcept {
+        for (auto& chunk : chunks_) {
+            upstream_->Deallocate(chunk.first, chunk.second);
+        }
+        chunks_.clear();
+        next_size_ = initial_size_;
+        cur_ = nullptr;
+        end_ = nullptr;
+        allocated_ = 0;
+    }
+
+    // Like Release, but the largest chunk is kept and reused, so a steady workload stops allocating.
+    void Reset() noexcept {
+        if (chunks_.empty()) {
+            return;
+        }
+        auto largest = std::max_element(chunks_.begin(), chunks_.end(),
+            [](const std::pair<char*, size_t>& a, const std::pair<char*, size_t>& b) { return a.second < b.second; });
+        auto keep = *largest;
+        for (auto& chunk : chunks_) {
+            if (chunk.first != keep.first) {
+                upstream_->Deallocate(chunk.first, chunk.second);
+            }
+        }
+        chunks_.clear();
+        chunks_.push_back(keep);
+        next_size_ = keep.second * 2;
+        cur_ = keep.first;
+        end_ = keep.first + keep.second;
+        allocated_ = 0;
+    }
+
+    // Bytes handed out since construction, the last Release or the last Reset.
+    size_t Allocated() const noexcept {
+        return allocated_;
+    }
+
+protected:
+    void* DoAllocate(size_t bytes, size_t alignment) override {
+        auto aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(cur_) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        if (!cur_ || aligned + bytes > end_) {
+            size_t size = std::max(next_size_, bytes + alignment);
+            auto chunk = static_cast<char*>(upstream_->Allocate(size));
+            chunks_.emplace_back(chunk, size);
+            next_size_ = size * 2;
+            cur_ = chunk;
+            end_ = chunk + size;
+            aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(cur_) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        }
+        cur_ = aligned + bytes;
+        allocated_ += bytes;
+        return aligned;
+    }
+
+    void DoDeallocate(void* /* ptr */, size_t /* bytes */, size_t /* alignment */) noexcept override { }
+
+private:
+    MemoryResource* upstream_;
+    std::vector<std::pair<char*, size_t>> chunks_;
+    size_t initial_size_;
+    size_t next_size_;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t allocated_ = 0;
+};
+
+// Standard allocator that captures the default resource when it is constructed.
+template <typename T>
+class Allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+public:
+    Allocator() noexcept : resource_(GetDefaultResource()) { }
+    Allocator(MemoryResource* resource) noexcept : resource_(resource) { }
+    template <typename U>
+    Allocator(const Allocator<U>& other) noexcept : resource_(other.Resource()) { }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(resource_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        resource_->Deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    MemoryResource* Resource() const noexcept {
+        return resource_;
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const noexcept {
+        return resource_ == other.Resource();
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const noexcept {
+        return resource_ != other.Resource();
+    }
+
+private:
+    MemoryResource* resource_;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_MEMORY_RESOURCE_HPP_
@@ -0,0 +1,42 @@
+#ifndef YUJSON_MEMORY_USAGE_HPP_
+#define YUJSON_MEMORY_USAGE_HPP_
+
+#include <cstddef>
+
+namespace yuJson {
+
+/*
+* Bytes held by a subtree, filled by Json::MemoryUsage.
+* Heap blocks are counted at their requested size, allocator bookkeeping is not included,
+* std::map nodes are estimated as the member pair plus three links and a color.
+*/
+struct MemoryUsage {
+    size_t values = 0;          // number of value nodes
+    size_t nodes = 0;           // value nodes, their resource header included
+    size_t members = 0;         // object map nodes
+    size_t elements = 0;        // used part of array storage
+    size_t keys = 0;            // heap buffers of object keys, short keys live inside the map node
+    size_t strings = 0;         // heap buffers of string values and kept number text
+    size_t slack = 0;           // unused array capacity and string capacity, see Json::ShrinkToFit
+
+    size_t Total() const noexcept {
+        return nodes + members + elements + keys + strings + slack;
+    }
+
+    // Calls func(name, value) for every counter, the same way as Stats::ForEach.
+    template <typename Func>
+    void ForEach(Func func) const {
+        func("values", values);
+        func("nodes", nodes);
+        func("members", members);
+        func("elements", elements);
+        func("keys", keys);
+        func("strings", strings);
+        func("slack", slack);
+        func("total", Total());
+    }
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_MEMORY_USAGE_HPP_
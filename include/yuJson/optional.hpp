@@ -0,0 +1,43 @@
+#ifndef YUJSON_OPTIONAL_HPP_
+#define YUJSON_OPTIONAL_HPP_
+
+#include <utility>
+
+namespace yuJson {
+
+// Minimal C++14 stand-in for std::optional, used by the non-throwing accessors.
+template <typename T>
+class Optional {
+public:
+    Optional() noexcept : has_value_(false), value_() { }
+    Optional(T value) : has_value_(true), value_(std::move(value)) { }
+
+public:
+    bool has_value() const noexcept {
+        return has_value_;
+    }
+
+    explicit operator bool() const noexcept {
+        return has_value_;
+    }
+
+    const T& operator*() const noexcept {
+        return value_;
+    }
+
+    const T* operator->() const noexcept {
+        return &value_;
+    }
+
+    T value_or(T default_value) const {
+        return has_value_ ? value_ : std::move(default_value);
+    }
+
+private:
+    bool has_value_;
+    T value_;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_OPTIONAL_HPP_
@@ -0,0 +1,66 @@
+#ifndef YUJSON_PARSER_CONTEXT_HPP_
+#define YUJSON_PARSER_CONTEXT_HPP_
+
+#include <yuJson/json.hpp>
+
+namespace yuJson {
+
+/*
+* Keeps the lexer buffers, the token buffer and the container stack of the parser between documents,
+* for parsing many small messages on one thread. Json::Parse builds all of them for every call.
+*
+* With use_arena the documents are allocated from an arena owned by the context. Reset makes its memory
+* available again and keeps the largest chunk, so once the buffers have grown a Parse / Reset cycle
+* performs no heap allocation, as long as the object keys fit the small string buffer of std::string.
+* Every document parsed since the last Reset must be destroyed before the next Reset.
+* Not thread-safe, use one context per thread.
+*/
+class ParserContext {
+public:
+    explicit ParserContext(const ParseOptions& options = ParseOptions{}, bool use_arena = false) :
+        lexer_(std::string()), parser_(&lexer_, options), use_arena_(use_arena) { }
+
+    ParserContext(const ParserContext&) = delete;
+    void operator=(const ParserContext&) = delete;
+
+public:
+    Json Parse(StringView json_text) {
+        return TryParse(json_text).json;
+    }
+
+    ParseResult TryParse(StringView json_text) {
+        lexer_.Reset(json_text.data(), json_text.size());
+        parser_.Reset();
+        ParseResult result;
+        if (use_arena_) {
+            MemoryResourceScope scope(&arena_);
+            result.json = Json(parser_.Parse());
+        }
+        else {
+            result.json = Json(parser_.Parse());
+        }
+        result.error = parser_.Error();
+        result.offset = parser_.ErrorOffset();
+        return result;
+    }
+
+    // Recycles the arena, see the class comment.
+    void Reset() noexcept {
+        arena_.Reset();
+    }
+
+    // Bytes taken from the arena since the last Reset.
+    size_t ArenaBytes() const noexcept {
+        return arena_.Allocated();
+    }
+
+private:
+    compiler::Lexer lexer_;
+    compiler::Parser parser_;
+    MonotonicResource arena_;
+    bool use_arena_;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_PARSER_CONTEXT_HPP_
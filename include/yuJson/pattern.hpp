@@ -0,0 +1,755 @@
+#ifndef YUJSON_PATTERN_HPP_
+#define YUJSON_PATTERN_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <yuJson/string_view.hpp>
+
+namespace yuJson {
+
+/*
+* A regular expression that is matched without backtracking, for JSON Schema "pattern" on untrusted input.
+* The ECMA-262 subset JSON Schema recommends for interoperability is compiled into a Thompson NFA and searched
+* in one pass over the input, so the time is linear in the input and nothing recurses on it.
+* Supported: literals, ., [...] with ranges and negation, \d \D \w \W \s \S \b \B, the character escapes,
+* groups and (?:...), |, * + ? {n} {n,} {n,m} greedy or lazy, ^ and $. Text is matched by code point.
+* Backreferences and lookaround fail to compile.
+*/
+class Pattern {
+public:
+    // Thread lists of a search, reused by the next one.
+    struct Scratch {
+        std::vector<uint32_t> current;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> marks;
+        std::vector<uint32_t> stack;
+    };
+
+public:
+    Pattern() noexcept { }
+
+    static Pattern Compile(StringView source) {
+        Pattern pattern;
+        Compiler compiler(source, &pattern);
+        uint32_t root;
+        if (!compiler.Parse(&root) || !pattern.Emit(compiler, root)) {
+            return Pattern();
+        }
+        pattern.program_.push_back(Inst{ Op::kMatch, 0, 0 });
+        pattern.valid_ = true;
+        return pattern;
+    }
+
+public:
+    bool IsValid() const noexcept {
+        return valid_;
+    }
+
+    // True if the pattern matches anywhere in text, as regex_search does.
+    bool Search(StringView text, Scratch* scratch) const {
+        if (!valid_) {
+            return false;
+        }
+        auto& current = scratch->current;
+        auto& next = scratch->next;
+        current.clear();
+        scratch->marks.assign(program_.size(), 0);
+        const char* pos = text.begin();
+        const char* end = text.end();
+        size_t length;
+        int32_t prev = kNoChar;
+        int32_t cur = pos < end ? Decode(pos, end, &length) : kNoChar;
+        uint32_t generation = 1;
+        while (true) {
+            // a match may start at every position
+            if (AddThread(&current, 0, prev, cur, generation, scratch)) {
+                return true;
+            }
+            if (cur == kNoChar) {
+                return false;
+            }
+            pos += length;
+            size_t next_length = 0;
+            int32_t following = pos < end ? Decode(pos, end, &next_length) : kNoChar;
+            ++generation;
+            next.clear();
+            for (auto pc : current) {
+                if (Consumes(program_[pc], cur) && AddThread(&next, pc + 1, cur, following, generation, scratch)) {
+                    return true;
+                }
+            }
+            current.swap(next);
+            prev = cur;
+            cur = following;
+            length = next_length;
+        }
+    }
+
+    bool Search(StringView text) const {
+        Scratch scratch;
+        return Search(text, &scratch);
+    }
+
+private:
+    static constexpr int32_t kNoChar = -1;
+    static constexpr uint32_t kInfinite = static_cast<uint32_t>(-1);
+    static constexpr uint32_t kMaxCount = 1000;        // largest {n,m} bound
+    static constexpr size_t kMaxProgram = 10000;       // instructions, repetitions are expanded
+    static constexpr size_t kMaxNesting = 100;         // groups, the parser recurses on them
+
+    enum class Op : uint8_t {
+        kChar,
+        kAny,
+        kClass,
+        kSplit,
+        kJmp,
+        kBegin,
+        kEnd,
+        kWordBoundary,
+        kNotWordBoundary,
+        kMatch
+    };
+
+    struct Inst {
+        Op op;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    struct Range {
+        uint32_t lo;
+        uint32_t hi;
+    };
+
+    struct Class {
+        std::vector<Range> ranges;
+        bool negated = false;
+    };
+
+    enum class NodeType : uint8_t {
+        kChar,
+        kAny,
+        kClass,
+        kBegin,
+        kEnd,
+        kWordBoundary,
+        kNotWordBoundary,
+        kConcat,
+        kAlternate,
+        kRepeat
+    };
+
+    struct Node {
+        NodeType type;
+        uint32_t value;             // code point or class
+        uint32_t min;
+        uint32_t max;
+        std::vector<uint32_t> children;
+    };
+
+    // Recursive descent over the source into a node tree.
+    class Compiler {
+    public:
+        Compiler(StringView source, Pattern* pattern) : pos_(source.begin()), end_(source.end()), pattern_(pattern) { }
+
+        bool Parse(uint32_t* root) {
+            return ParseAlternate(root) && pos_ == end_;
+        }
+
+        std::vector<Node> nodes;
+
+    private:
+        bool ParseAlternate(uint32_t* index) {
+            if (++depth_ > kMaxNesting) {
+                return false;
+            }
+            uint32_t first;
+            if (!ParseConcat(&first)) {
+                return false;
+            }
+            if (pos_ == end_ || *pos_ != '|') {
+                *index = first;
+                --depth_;
+                return true;
+            }
+            *index = AddNode(NodeType::kAlternate);
+            nodes[*index].children.push_back(first);
+            while (pos_ < end_ && *pos_ == '|') {
+                ++pos_;
+                uint32_t branch;
+                if (!ParseConcat(&branch)) {
+                    return false;
+                }
+                nodes[*index].children.push_back(branch);
+            }
+            --depth_;
+            return true;
+        }
+
+        bool ParseConcat(uint32_t* index) {
+            *index = AddNode(NodeType::kConcat);
+            while (pos_ < end_ && *pos_ != '|' && *pos_ != ')') {
+                uint32_t atom;
+                if (!ParseRepeat(&atom)) {
+                    return false;
+                }
+                nodes[*index].children.push_back(atom);
+            }
+            return true;
+        }
+
+        bool ParseRepeat(uint32_t* index) {
+            if (!ParseAtom(index)) {
+                return false;
+            }
+            if (pos_ == end_) {
+                return true;
+            }
+            uint32_t min;
+            uint32_t max;
+            if (*pos_ == '*') {
+                min = 0;
+                max = kInfinite;
+                ++pos_;
+            }
+            else if (*pos_ == '+') {
+                min = 1;
+                max = kInfinite;
+                ++pos_;
+            }
+            else if (*pos_ == '?') {
+                min = 0;
+                max = 1;
+                ++pos_;
+            }
+            else if (*pos_ != '{' || !ParseBraces(&min, &max)) {
+                // a { that does not start a quantifier is a literal
+                return !invalid_;
+            }
+            if (pos_ < end_ && *pos_ == '?') {
+                // lazy, makes no difference to whether there is a match
+                ++pos_;
+            }
+            if (pos_ < end_ && (*pos_ == '*' || *pos_ == '+' || *pos_ == '?' || *pos_ == '{')) {
+                uint32_t ignored_min, ignored_max;
+                auto save = pos_;
+                if (*pos_ != '{' || ParseBraces(&ignored_min, &ignored_max) || invalid_) {
+                    return false;
+                }
+                pos_ = save;
+            }
+            uint32_t repeat = AddNode(NodeType::kRepeat);
+            nodes[repeat].min = min;
+            nodes[repeat].max = max;
+            nodes[repeat].children.push_back(*index);
+            *index = repeat;
+            return true;
+        }
+
+        // {n}, {n,} or {n,m}, pos_ is left as it was when it is none of them.
+        bool ParseBraces(uint32_t* min, uint32_t* max) {
+            auto save = pos_;
+            ++pos_;
+            if (!ParseNumber(min)) {
+                pos_ = save;
+                return false;
+            }
+            *max = *min;
+            if (pos_ < end_ && *pos_ == ',') {
+                ++pos_;
+                *max = kInfinite;
+                if (pos_ < end_ && *pos_ != '}' && !ParseNumber(max)) {
+                    pos_ = save;
+                    return false;
+                }
+            }
+            if (pos_ == end_ || *pos_ != '}') {
+                pos_ = save;
+                return false;
+            }
+            ++pos_;
+            if (*min > *max || *min > kMaxCount || (*max != kInfinite && *max > kMaxCount)) {
+                // a quantifier, but not one that can be used
+                invalid_ = true;
+                return false;
+            }
+            return true;
+        }
+
+        bool ParseNumber(uint32_t* number) {
+            if (pos_ == end_ || *pos_ < '0' || *pos_ > '9') {
+                return false;
+            }
+            uint64_t value = 0;
+            while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+                value = value * 10 + (*pos_++ - '0');
+                if (value > kMaxCount + 1) {
+                    value = kMaxCount + 1;
+                }
+            }
+            *number = static_cast<uint32_t>(value);
+            return true;
+        }
+
+        bool ParseAtom(uint32_t* index) {
+            char c = *pos_;
+            switch (c) {
+            case '(': {
+                ++pos_;
+                if (pos_ < end_ && *pos_ == '?') {
+                    // only (?:...), lookaround and named groups are not supported
+                    if (pos_ + 1 == end_ || pos_[1] != ':') {
+                        return false;
+                    }
+                    pos_ += 2;
+                }
+                if (!ParseAlternate(index) || pos_ == end_ || *pos_ != ')') {
+                    return false;
+                }
+                ++pos_;
+                return true;
+            }
+            case '.':
+                ++pos_;
+                *index = AddNode(NodeType::kAny);
+                return true;
+            case '^':
+                ++pos_;
+                *index = AddNode(NodeType::kBegin);
+                return true;
+            case '$':
+                ++pos_;
+                *index = AddNode(NodeType::kEnd);
+                return true;
+            case '[':
+                return ParseClass(index);
+            case '*':
+            case '+':
+            case '?':
+                return false;
+            case '\\': {
+                ++pos_;
+                if (pos_ == end_) {
+                    return false;
+                }
+                if (*pos_ == 'b' || *pos_ == 'B') {
+                    *index = AddNode(*pos_++ == 'b' ? NodeType::kWordBoundary : NodeType::kNotWordBoundary);
+                    return true;
+                }
+                uint32_t cp;
+                Class set;
+                bool is_set;
+                if (!ParseEscape(&cp, &set, &is_set)) {
+                    return false;
+                }
+                if (is_set) {
+                    *index = AddClass(std::move(set));
+                }
+                else {
+                    *index = AddNode(NodeType::kChar);
+                    nodes[*index].value = cp;
+                }
+                return true;
+            }
+            default: {
+                size_t length;
+                *index = AddNode(NodeType::kChar);
+                nodes[*index].value = static_cast<uint32_t>(Decode(pos_, end_, &length));
+                pos_ += length;
+                return true;
+            }
+            }
+        }
+
+        bool ParseClass(uint32_t* index) {
+            ++pos_;
+            Class set;
+            if (pos_ < end_ && *pos_ == '^') {
+                set.negated = true;
+                ++pos_;
+            }
+            bool first = true;
+            while (pos_ < end_ && (*pos_ != ']' || first)) {
+                first = false;
+                uint32_t lo;
+                bool lo_is_set;
+                if (!ParseClassAtom(&set, &lo, &lo_is_set)) {
+                    return false;
+                }
+                if (lo_is_set) {
+                    continue;
+                }
+                if (pos_ + 1 < end_ && *pos_ == '-' && pos_[1] != ']') {
+                    ++pos_;
+                    uint32_t hi;
+                    bool hi_is_set;
+                    if (!ParseClassAtom(&set, &hi, &hi_is_set) || hi_is_set || hi < lo) {
+                        return false;
+                    }
+                    set.ranges.push_back(Range{ lo, hi });
+                }
+                else {
+                    set.ranges.push_back(Range{ lo, lo });
+                }
+            }
+            if (pos_ == end_) {
+                return false;
+            }
+            ++pos_;
+            *index = AddClass(std::move(set));
+            return true;
+        }
+
+        // One character of a class into *cp, or the ranges of \d, \w, \s and their negations added to set.
+        bool ParseClassAtom(Class* set, uint32_t* cp, bool* is_set) {
+            if (*pos_ != '\\') {
+                size_t length;
+                *cp = static_cast<uint32_t>(Decode(pos_, end_, &length));
+                pos_ += length;
+                *is_set = false;
+                return true;
+            }
+            ++pos_;
+            if (pos_ == end_) {
+                return false;
+            }
+            if (*pos_ == 'b') {
+                // backspace inside a class
+                ++pos_;
+                *cp = 8;
+                *is_set = false;
+                return true;
+            }
+            Class escaped;
+            if (!ParseEscape(cp, &escaped, is_set)) {
+                return false;
+            }
+            if (*is_set && escaped.negated) {
+                AppendComplement(escaped.ranges, &set->ranges);
+            }
+            else if (*is_set) {
+                set->ranges.insert(set->ranges.end(), escaped.ranges.begin(), escaped.ranges.end());
+            }
+            return true;
+        }
+
+        // After the backslash, a character or a class escape.
+        bool ParseEscape(uint32_t* cp, Class* set, bool* is_set) {
+            char c = *pos_++;
+            *is_set = false;
+            switch (c) {
+            case 'd': case 'D':
+                set->ranges = { Range{ '0', '9' } };
+                break;
+            case 'w': case 'W':
+                set->ranges = { Range{ '0', '9' }, Range{ 'A', 'Z' }, Range{ '_', '_' }, Range{ 'a', 'z' } };
+                break;
+            case 's': case 'S':
+                set->ranges = { Range{ 0x09, 0x0d }, Range{ 0x20, 0x20 }, Range{ 0xa0, 0xa0 }, Range{ 0x1680, 0x1680 },
+                    Range{ 0x2000, 0x200a }, Range{ 0x2028, 0x2029 }, Range{ 0x202f, 0x202f }, Range{ 0x205f, 0x205f },
+                    Range{ 0x3000, 0x3000 }, Range{ 0xfeff, 0xfeff } };
+                break;
+            case 't': *cp = '\t'; return true;
+            case 'n': *cp = '\n'; return true;
+            case 'v': *cp = '\v'; return true;
+            case 'f': *cp = '\f'; return true;
+            case 'r': *cp = '\r'; return true;
+            case '0':
+                if (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+                    return false;
+                }
+                *cp = 0;
+                return true;
+            case 'c':
+                if (pos_ == end_ || !((*pos_ >= 'a' && *pos_ <= 'z') || (*pos_ >= 'A' && *pos_ <= 'Z'))) {
+                    return false;
+                }
+                *cp = static_cast<uint32_t>(*pos_++) % 32;
+                return true;
+            case 'x':
+                return ParseHex(2, cp);
+            case 'u':
+                return ParseHex(4, cp);
+            default:
+                // backreferences and unknown letter escapes are errors, punctuation stands for itself
+                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+                    return false;
+                }
+                --pos_;
+                size_t length;
+                *cp = static_cast<uint32_t>(Decode(pos_, end_, &length));
+                pos_ += length;
+                return true;
+            }
+            set->negated = c == 'D' || c == 'W' || c == 'S';
+            *is_set = true;
+            return true;
+        }
+
+        bool ParseHex(size_t digits, uint32_t* cp) {
+            if (static_cast<size_t>(end_ - pos_) < digits) {
+                return false;
+            }
+            uint32_t value = 0;
+            for (size_t i = 0; i < digits; i++) {
+                char c = *pos_++;
+                value *= 16;
+                if (c >= '0' && c <= '9') value += c - '0';
+                else if (c >= 'a' && c <= 'f') value += c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') value += c - 'A' + 10;
+                else return false;
+            }
+            *cp = value;
+            return true;
+        }
+
+        static void AppendComplement(const std::vector<Range>& ranges, std::vector<Range>* out) {
+            // the predefined sets are sorted and disjoint
+            uint32_t lo = 0;
+            for (auto& range : ranges) {
+                if (range.lo > lo) {
+                    out->push_back(Range{ lo, range.lo - 1 });
+                }
+                lo = range.hi + 1;
+            }
+            out->push_back(Range{ lo, 0x10ffff });
+        }
+
+        uint32_t AddNode(NodeType type) {
+            nodes.push_back(Node{ type, 0, 0, 0, {} });
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
+
+        uint32_t AddClass(Class set) {
+            uint32_t index = AddNode(NodeType::kClass);
+            nodes[index].value = static_cast<uint32_t>(pattern_->classes_.size());
+            pattern_->classes_.push_back(std::move(set));
+            return index;
+        }
+
+    private:
+        const char* pos_;
+        const char* end_;
+        Pattern* pattern_;
+        size_t depth_ = 0;
+        bool invalid_ = false;
+    };
+
+private:
+    // Appends the code of a node, false once the program grows too large.
+    bool Emit(const Compiler& compiler, uint32_t index) {
+        if (program_.size() > kMaxProgram) {
+            return false;
+        }
+        auto& node = compiler.nodes[index];
+        switch (node.type) {
+        case NodeType::kChar:
+            program_.push_back(Inst{ Op::kChar, node.value, 0 });
+            return true;
+        case NodeType::kAny:
+            program_.push_back(Inst{ Op::kAny, 0, 0 });
+            return true;
+        case NodeType::kClass:
+            program_.push_back(Inst{ Op::kClass, node.value, 0 });
+            return true;
+        case NodeType::kBegin:
+            program_.push_back(Inst{ Op::kBegin, 0, 0 });
+            return true;
+        case NodeType::kEnd:
+            program_.push_back(Inst{ Op::kEnd, 0, 0 });
+            return true;
+        case NodeType::kWordBoundary:
+            program_.push_back(Inst{ Op::kWordBoundary, 0, 0 });
+            return true;
+        case NodeType::kNotWordBoundary:
+            program_.push_back(Inst{ Op::kNotWordBoundary, 0, 0 });
+            return true;
+        case NodeType::kConcat:
+            for (auto child : node.children) {
+                if (!Emit(compiler, child)) {
+                    return false;
+                }
+            }
+            return true;
+        case NodeType::kAlternate: {
+            std::vector<size_t> jumps;
+            for (size_t i = 0; i < node.children.size(); i++) {
+                if (i + 1 == node.children.size()) {
+                    if (!Emit(compiler, node.children[i])) {
+                        return false;
+                    }
+                    break;
+                }
+                size_t split = program_.size();
+                program_.push_back(Inst{ Op::kSplit, static_cast<uint32_t>(split + 1), 0 });
+                if (!Emit(compiler, node.children[i])) {
+                    return false;
+                }
+                jumps.push_back(program_.size());
+                program_.push_back(Inst{ Op::kJmp, 0, 0 });
+                program_[split].y = static_cast<uint32_t>(program_.size());
+            }
+            for (auto jump : jumps) {
+                program_[jump].x = static_cast<uint32_t>(program_.size());
+            }
+            return true;
+        }
+        case NodeType::kRepeat: {
+            auto child = node.children[0];
+            for (uint32_t i = 0; i < node.min; i++) {
+                if (!Emit(compiler, child)) {
+                    return false;
+                }
+            }
+            if (node.max == kInfinite) {
+                size_t split = program_.size();
+                program_.push_back(Inst{ Op::kSplit, static_cast<uint32_t>(split + 1), 0 });
+                if (!Emit(compiler, child)) {
+                    return false;
+                }
+                program_.push_back(Inst{ Op::kJmp, static_cast<uint32_t>(split), 0 });
+                program_[split].y = static_cast<uint32_t>(program_.size());
+                return true;
+            }
+            std::vector<size_t> splits;
+            for (uint32_t i = node.min; i < node.max; i++) {
+                splits.push_back(program_.size());
+                program_.push_back(Inst{ Op::kSplit, static_cast<uint32_t>(program_.size() + 1), 0 });
+                if (!Emit(compiler, child)) {
+                    return false;
+                }
+            }
+            for (auto split : splits) {
+                program_[split].y = static_cast<uint32_t>(program_.size());
+            }
+            return true;
+        }
+        }
+        return false;
+    }
+
+    // Follows the instructions that consume nothing from pc and adds the threads that wait for a character.
+    // True once the match instruction is reached.
+    bool AddThread(std::vector<uint32_t>* list, uint32_t pc, int32_t prev, int32_t cur, uint32_t generation, Scratch* scratch) const {
+        auto& stack = scratch->stack;
+        auto& marks = scratch->marks;
+        stack.clear();
+        stack.push_back(pc);
+        while (!stack.empty()) {
+            pc = stack.back();
+            stack.pop_back();
+            if (marks[pc] == generation) {
+                continue;
+            }
+            marks[pc] = generation;
+            auto& inst = program_[pc];
+            switch (inst.op) {
+            case Op::kMatch:
+                return true;
+            case Op::kJmp:
+                stack.push_back(inst.x);
+                break;
+            case Op::kSplit:
+                stack.push_back(inst.y);
+                stack.push_back(inst.x);
+                break;
+            case Op::kBegin:
+                if (prev == kNoChar) {
+                    stack.push_back(pc + 1);
+                }
+                break;
+            case Op::kEnd:
+                if (cur == kNoChar) {
+                    stack.push_back(pc + 1);
+                }
+                break;
+            case Op::kWordBoundary:
+            case Op::kNotWordBoundary:
+                if ((IsWord(prev) != IsWord(cur)) == (inst.op == Op::kWordBoundary)) {
+                    stack.push_back(pc + 1);
+                }
+                break;
+            default:
+                list->push_back(pc);
+                break;
+            }
+        }
+        return false;
+    }
+
+    bool Consumes(const Inst& inst, int32_t c) const noexcept {
+        auto cp = static_cast<uint32_t>(c);
+        switch (inst.op) {
+        case Op::kChar:
+            return inst.x == cp;
+        case Op::kAny:
+            return cp != '\n' && cp != '\r' && cp != 0x2028 && cp != 0x2029;
+        case Op::kClass: {
+            auto& set = classes_[inst.x];
+            bool in = false;
+            for (auto& range : set.ranges) {
+                if (cp >= range.lo && cp <= range.hi) {
+                    in = true;
+                    break;
+                }
+            }
+            return in != set.negated;
+        }
+        default:
+            return false;
+        }
+    }
+
+    static bool IsWord(int32_t c) noexcept {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+    }
+
+    // The code point at pos, a byte that does not start a well-formed sequence stands for itself.
+    static int32_t Decode(const char* pos, const char* end, size_t* length) noexcept {
+        auto bytes = reinterpret_cast<const unsigned char*>(pos);
+        size_t available = static_cast<size_t>(end - pos);
+        auto c = bytes[0];
+        *length = 1;
+        size_t count;
+        uint32_t cp;
+        if (c < 0x80) {
+            return c;
+        }
+        else if (c >= 0xc2 && c <= 0xdf) {
+            count = 2;
+            cp = c & 0x1f;
+        }
+        else if (c >= 0xe0 && c <= 0xef) {
+            count = 3;
+            cp = c & 0x0f;
+        }
+        else if (c >= 0xf0 && c <= 0xf4) {
+            count = 4;
+            cp = c & 0x07;
+        }
+        else {
+            return c;
+        }
+        if (available < count) {
+            return c;
+        }
+        for (size_t i = 1; i < count; i++) {
+            if ((bytes[i] & 0xc0) != 0x80) {
+                return c;
+            }
+            cp = (cp << 6) | (bytes[i] & 0x3f);
+        }
+        *length = count;
+        return static_cast<int32_t>(cp);
+    }
+
+private:
+    std::vector<Inst> program_;
+    std::vector<Class> classes_;
+    bool valid_ = false;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_PATTERN_HPP_
@@ -0,0 +1,136 @@
+#ifndef YUJSON_RECLAIMER_HPP_
+#define YUJSON_RECLAIMER_HPP_
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <yuJson/value/value.hpp>
+
+namespace yuJson {
+
+/*
+* Takes ownership of detached trees and frees them later, see Json::ReleaseAsync.
+* The memory resources the trees were allocated from must outlive the reclamation.
+*/
+class Reclaimer {
+public:
+    virtual ~Reclaimer() noexcept { }
+
+public:
+    virtual void Reclaim(value::ValuePtr value) = 0;
+};
+
+// Frees trees on its own worker thread, the calling thread only pays for a queue push.
+class BackgroundReclaimer : public Reclaimer {
+public:
+    BackgroundReclaimer() : thread_([this] { Run(); }) { }
+    ~BackgroundReclaimer() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        queue_cond_.notify_one();
+        thread_.join();
+    }
+
+    BackgroundReclaimer(const BackgroundReclaimer&) = delete;
+    void operator=(const BackgroundReclaimer&) = delete;
+
+    void Reclaim(value::ValuePtr value) override {
+        if (!value) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(value));
+            ++queued_;
+        }
+        queue_cond_.notify_one();
+    }
+
+    // Blocks until every tree queued before the call is freed.
+    void Flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto target = queued_;
+        freed_cond_.wait(lock, [&] { return freed_ >= target; });
+    }
+
+private:
+    void Run() {
+        std::vector<value::ValuePtr> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                queue_cond_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                // keep the capacity of both buffers, the queue gets the empty one back
+                batch.swap(queue_);
+            }
+            auto count = batch.size();
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                freed_ += count;
+            }
+            freed_cond_.notify_all();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable queue_cond_;
+    std::condition_variable freed_cond_;
+    std::vector<value::ValuePtr> queue_;
+    uint64_t queued_ = 0;
+    uint64_t freed_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// Collects trees until Drain is called, e.g. once per event loop iteration.
+class DeferredReclaimer : public Reclaimer {
+public:
+    ~DeferredReclaimer() noexcept {
+        Drain();
+    }
+
+    void Reclaim(value::ValuePtr value) override {
+        if (!value) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(value));
+    }
+
+    // Frees everything reclaimed so far on the calling thread.
+    void Drain() noexcept {
+        std::vector<value::ValuePtr> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(pending_);
+        }
+    }
+
+    size_t Pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<value::ValuePtr> pending_;
+};
+
+// Process wide BackgroundReclaimer used by Json::ReleaseAsync when none is given.
+inline BackgroundReclaimer* DefaultReclaimer() {
+    static BackgroundReclaimer reclaimer;
+    return &reclaimer;
+}
+
+} // namespace yuJson
+
+#endif // YUJSON_RECLAIMER_HPP_
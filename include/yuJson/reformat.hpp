@@ -0,0 +1,267 @@
+#ifndef YUJSON_REFORMAT_HPP_
+#define YUJSON_REFORMAT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <yuJson/string_view.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace yuJson {
+namespace reformat {
+
+inline unsigned TrailingZeros(uint32_t mask) noexcept {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline bool IsSpace(char c) noexcept {
+    // control characters are not valid between tokens, they go with the whitespace
+    return static_cast<unsigned char>(c) <= 0x20;
+}
+
+// Offset of the first whitespace or quote, size if there is none.
+inline size_t FindSpaceOrQuote(const char* data, size_t size) noexcept {
+    size_t i = 0;
+#if defined(__AVX2__)
+    auto space = _mm256_set1_epi8(0x20);
+    auto quote = _mm256_set1_epi8('"');
+    for (; i + 32 <= size; i += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto special = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(block, space), block), _mm256_cmpeq_epi8(block, quote));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            return i + TrailingZeros(mask);
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    auto space = _mm_set1_epi8(0x20);
+    auto quote = _mm_set1_epi8('"');
+    for (; i + 16 <= size; i += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto special = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(block, space), block), _mm_cmpeq_epi8(block, quote));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return i + TrailingZeros(mask);
+        }
+    }
+#endif
+    while (i < size && !IsSpace(data[i]) && data[i] != '"') {
+        ++i;
+    }
+    return i;
+}
+
+// Offset of the first quote or backslash, size if there is none.
+inline size_t FindQuoteOrEscape(const char* data, size_t size) noexcept {
+    size_t i = 0;
+#if defined(__AVX2__)
+    auto quote = _mm256_set1_epi8('"');
+    auto backslash = _mm256_set1_epi8('\\');
+    for (; i + 32 <= size; i += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto special = _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            return i + TrailingZeros(mask);
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    auto quote = _mm_set1_epi8('"');
+    auto backslash = _mm_set1_epi8('\\');
+    for (; i + 16 <= size; i += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto special = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return i + TrailingZeros(mask);
+        }
+    }
+#endif
+    while (i < size && data[i] != '"' && data[i] != '\\') {
+        ++i;
+    }
+    return i;
+}
+
+// Length of the string that starts with the quote at data[0], closing quote included. 0 if it is not closed.
+inline size_t StringLength(const char* data, size_t size) noexcept {
+    size_t i = 1;
+    while (true) {
+        i += FindQuoteOrEscape(data + i, size - i);
+        if (i >= size) {
+            return 0;
+        }
+        if (data[i] == '"') {
+            return i + 1;
+        }
+        // the escaped character cannot end the string
+        i += 2;
+        if (i > size) {
+            return 0;
+        }
+    }
+}
+
+// Drops the whitespace outside strings, write(const char*, size_t) receives the rest in order.
+template <typename Write>
+bool Minify(const char* data, size_t size, Write&& write) {
+    size_t i = 0;
+    while (i < size) {
+        size_t run = FindSpaceOrQuote(data + i, size - i);
+        if (run > 0) {
+            write(data + i, run);
+            i += run;
+        }
+        if (i == size) {
+            break;
+        }
+        if (data[i] == '"') {
+            size_t length = StringLength(data + i, size - i);
+            if (length == 0) {
+                return false;
+            }
+            write(data + i, length);
+            i += length;
+            continue;
+        }
+        while (i < size && IsSpace(data[i])) {
+            ++i;
+        }
+    }
+    return true;
+}
+
+} // namespace reformat
+
+/*
+* Reformatting straight on the text, without Parse and Print: strings and numbers are copied as written.
+* One JSON text is expected and it is not validated, Parse it first if it may be malformed.
+* False for a string that is not closed and, for Prettify, brackets that do not balance; the output then
+* holds what came before.
+*/
+
+// Appends json_text without whitespace outside the strings to output.
+inline bool Minify(StringView json_text, std::string* output) {
+    return reformat::Minify(json_text.data(), json_text.size(), [output](const char* data, size_t size) {
+        output->append(data, size);
+    });
+}
+
+// Minifies data in place, *size becomes the new size. On failure *size covers what was minified.
+inline bool MinifyInPlace(char* data, size_t* size) {
+    char* out = data;
+    bool success = reformat::Minify(data, *size, [&out](const char* run, size_t length) {
+        // the output never gets ahead of the input
+        if (out != run) {
+            std::memmove(out, run, length);
+        }
+        out += length;
+    });
+    *size = static_cast<size_t>(out - data);
+    return success;
+}
+
+inline bool MinifyInPlace(std::string* json_text) {
+    size_t size = json_text->size();
+    bool success = MinifyInPlace(&(*json_text)[0], &size);
+    json_text->resize(size);
+    return success;
+}
+
+// Appends json_text to output with one member or element per line, nested indent spaces deeper. Empty containers stay {} and [].
+inline bool Prettify(StringView json_text, std::string* output, size_t indent = 4) {
+    const char* data = json_text.data();
+    size_t size = json_text.size();
+    size_t depth = 0;
+    auto new_line = [&]() {
+        output->push_back('\n');
+        output->append(depth * indent, ' ');
+    };
+    size_t i = 0;
+    while (i < size) {
+        char c = data[i];
+        switch (c) {
+        case '"': {
+            size_t length = reformat::StringLength(data + i, size - i);
+            if (length == 0) {
+                return false;
+            }
+            output->append(data + i, length);
+            i += length;
+            break;
+        }
+        case '{':
+        case '[': {
+            char close = c == '{' ? '}' : ']';
+            size_t next = i + 1;
+            while (next < size && reformat::IsSpace(data[next])) {
+                ++next;
+            }
+            output->push_back(c);
+            if (next < size && data[next] == close) {
+                output->push_back(close);
+                i = next + 1;
+                break;
+            }
+            ++depth;
+            new_line();
+            i = next;
+            break;
+        }
+        case '}':
+        case ']':
+            if (depth == 0) {
+                return false;
+            }
+            --depth;
+            new_line();
+            output->push_back(c);
+            ++i;
+            break;
+        case ',':
+            output->push_back(',');
+            new_line();
+            ++i;
+            break;
+        case ':':
+            output->append(": ");
+            ++i;
+            break;
+        default: {
+            if (reformat::IsSpace(c)) {
+                ++i;
+                break;
+            }
+            // a number or a literal
+            size_t end = i + 1;
+            while (end < size && !reformat::IsSpace(data[end]) && !std::strchr(",:]}\"", data[end])) {
+                ++end;
+            }
+            output->append(data + i, end - i);
+            i = end;
+            break;
+        }
+        }
+    }
+    return depth == 0;
+}
+
+} // namespace yuJson
+
+#endif // YUJSON_REFORMAT_HPP_
@@ -0,0 +1,74 @@
+#ifndef YUJSON_STATS_HPP_
+#define YUJSON_STATS_HPP_
+
+// #define YUJSON_ENABLE_STATS
+
+#include <cstdint>
+#include <string>
+
+#include <yuJson/compiler/token.hpp>
+
+namespace yuJson {
+
+/*
+* Counters filled by Json::Parse / Json::Print when a Stats* is passed in.
+* Collection is compiled in only with YUJSON_ENABLE_STATS, otherwise every counter stays 0
+* and the lexer / parser carry no extra state.
+*/
+struct Stats {
+    uint64_t parse_bytes = 0;
+    uint64_t parse_ns = 0;          // whole Parse call, lexing included
+    uint64_t lex_ns = 0;
+    uint64_t tokens[compiler::kTokenTypeCount] = {};
+    uint64_t max_depth = 0;
+    // Estimated from the value types, not counted at the allocator: value nodes, heap string buffers,
+    // array growth and map nodes. Node headers, allocator rounding and the heap buffers of long
+    // object keys are left out, see memory_resource.hpp.
+    uint64_t estimated_allocations = 0;
+    uint64_t estimated_allocated_bytes = 0;
+
+    uint64_t print_bytes = 0;
+    uint64_t print_ns = 0;
+
+    void Merge(const Stats& other) noexcept {
+        parse_bytes += other.parse_bytes;
+        parse_ns += other.parse_ns;
+        lex_ns += other.lex_ns;
+        for (size_t i = 0; i < compiler::kTokenTypeCount; i++) {
+            tokens[i] += other.tokens[i];
+        }
+        if (other.max_depth > max_depth) {
+            max_depth = other.max_depth;
+        }
+        estimated_allocations += other.estimated_allocations;
+        estimated_allocated_bytes += other.estimated_allocated_bytes;
+        print_bytes += other.print_bytes;
+        print_ns += other.print_ns;
+    }
+
+    // Calls func(name, value) for every counter, for exporting to a metrics system.
+    template <typename Func>
+    void ForEach(Func func) const {
+        static const char* kTokenNames[compiler::kTokenTypeCount] = {
+            "tokens.none", "tokens.eof", "tokens.null", "tokens.true", "tokens.false",
+            "tokens.number_int", "tokens.number_float", "tokens.string",
+            "tokens.lbrack", "tokens.rbrack", "tokens.lcurly", "tokens.rcurly",
+            "tokens.comma", "tokens.colon", "tokens.minus",
+        };
+        func("parse_bytes", parse_bytes);
+        func("parse_ns", parse_ns);
+        func("lex_ns", lex_ns);
+        for (size_t i = 0; i < compiler::kTokenTypeCount; i++) {
+            func(kTokenNames[i], tokens[i]);
+        }
+        func("max_depth", max_depth);
+        func("estimated_allocations", estimated_allocations);
+        func("estimated_allocated_bytes", estimated_allocated_bytes);
+        func("print_bytes", print_bytes);
+        func("print_ns", print_ns);
+    }
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_STATS_HPP_
@@ -0,0 +1,579 @@
+#ifndef YUJSON_STREAM_TRANSFORMER_HPP_
+#define YUJSON_STREAM_TRANSFORMER_HPP_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <limits>
+
+#include <yuJson/string_view.hpp>
+#include <yuJson/escape.hpp>
+#include <yuJson/value/value.hpp>
+#include <yuJson/compiler/lexer.hpp>
+#include <yuJson/compiler/parser.hpp>
+#include <yuJson/compiler/reader.hpp>
+
+namespace yuJson {
+
+// Receives the output of a StreamTransformer in pieces.
+class OutputSink {
+public:
+    virtual ~OutputSink() noexcept { }
+
+public:
+    // False stops the transformation with kWriteFailed.
+    virtual bool Write(const char* data, size_t size) = 0;
+};
+
+/*
+* A matched member or element as handed to a StreamTransformer callback, which decides what becomes of it.
+* Without a call the value is copied as it is.
+*/
+class FieldEdit {
+public:
+    friend class StreamTransformer;
+
+public:
+    // Name of the member, empty for an array element and for a top-level value.
+    StringView Key() const noexcept {
+        return key_;
+    }
+
+    // Position in the enclosing array or object.
+    size_t Index() const noexcept {
+        return index_;
+    }
+
+    bool IsMember() const noexcept {
+        return is_member_;
+    }
+
+    value::ValueType Type() const noexcept {
+        return type_;
+    }
+
+    // The value as written, quotes and escapes included. Empty for arrays and objects, they have not been read yet.
+    StringView Raw() const noexcept {
+        return raw_;
+    }
+
+    // Leaves out the value, for a member its name too.
+    void Drop() noexcept {
+        action_ = Action::kDrop;
+    }
+
+    // Writes json_text instead of the value, it is not checked.
+    void Replace(StringView json_text) {
+        action_ = Action::kReplace;
+        replacement_.assign(json_text.data(), json_text.size());
+    }
+
+    // Gives a member another name, the value is still transformed. Ignored for elements.
+    void Rename(StringView name) {
+        renamed_ = is_member_;
+        name_.assign(name.data(), name.size());
+    }
+
+private:
+    enum class Action {
+        kKeep,
+        kDrop,
+        kReplace
+    };
+
+    StringView key_;
+    size_t index_ = 0;
+    bool is_member_ = false;
+    value::ValueType type_ = value::ValueType::kNull;
+    StringView raw_;
+    Action action_ = Action::kKeep;
+    bool renamed_ = false;
+    std::string replacement_;
+    std::string name_;
+};
+
+/*
+* Rewrites JSON text into JSON text without building a tree, e.g. to redact or rename fields of log records.
+* The input is read with compiler::Lexer, everything no rule matches is copied byte for byte, whitespace included.
+* Only the current path is kept, so memory stays bounded by the nesting depth and the longest token
+* when reading from an InputSource and writing to an OutputSink.
+*
+* The input may hold several top-level values separated by whitespace, as JSON Lines do, each is transformed alike.
+* Values dropped or replaced are skipped token by token; their brackets must balance, the rest of them is not checked.
+*/
+class StreamTransformer {
+public:
+    using Callback = std::function<void(FieldEdit*)>;
+
+public:
+    explicit StreamTransformer(const compiler::ParseOptions& options = compiler::ParseOptions{}) : string_lexer_(std::string()), options_(options) { }
+
+    StreamTransformer(const StreamTransformer&) = delete;
+    void operator=(const StreamTransformer&) = delete;
+
+public:
+    // Calls callback for every value at path, a JSON Pointer in which a "*" token matches any one member or element
+    // and a "**" token any number of levels, e.g. "/**/password". "" is a top-level value.
+    // Callbacks run in the order they were added, until one drops or replaces the value. False if path is not a JSON Pointer.
+    bool On(StringView path, Callback callback) {
+        Rule rule;
+        if (!SplitPointer(path, &rule.tokens)) {
+            return false;
+        }
+        for (auto& token : rule.tokens) {
+            rule.has_globstar |= token == "**";
+        }
+        rule.literal_last = !rule.tokens.empty() && rule.tokens.back() != "*" && rule.tokens.back() != "**";
+        rule.callback = std::move(callback);
+        rules_.push_back(std::move(rule));
+        return true;
+    }
+
+    bool Drop(StringView path) {
+        return On(path, [](FieldEdit* edit) { edit->Drop(); });
+    }
+
+    bool Replace(StringView path, StringView json_text) {
+        std::string text(json_text.data(), json_text.size());
+        return On(path, [text](FieldEdit* edit) { edit->Replace(text); });
+    }
+
+    bool Rename(StringView path, StringView name) {
+        std::string new_name(name.data(), name.size());
+        return On(path, [new_name](FieldEdit* edit) { edit->Rename(new_name); });
+    }
+
+    // Appends the transformed input to output. On failure output holds some of what came before the error.
+    bool Transform(StringView input, std::string* output) {
+        string_lexer_.Reset(input.data(), input.size());
+        lexer_ = &string_lexer_;
+        output_ = output;
+        sink_ = nullptr;
+        return Run();
+    }
+
+    // Reads input as it arrives and writes the output in pieces of about kFlushBytes.
+    bool Transform(compiler::InputSource* input, OutputSink* output) {
+        compiler::Lexer lexer(input);
+        lexer_ = &lexer;
+        buffer_.clear();
+        output_ = &buffer_;
+        sink_ = output;
+        bool success = Run() && Flush();
+        if (success && input->Failed()) {
+            success = Fail(compiler::ParseError::kReadFailed, lexer.Offset());
+        }
+        lexer_ = nullptr;
+        return success;
+    }
+
+    compiler::ParseError Error() const noexcept {
+        return error_;
+    }
+
+    size_t ErrorOffset() const noexcept {
+        return error_offset_;
+    }
+
+public:
+    static constexpr size_t kFlushBytes = 64 * 1024;
+
+private:
+    using Token = compiler::Token;
+
+    struct Rule {
+        std::vector<std::string> tokens;
+        bool has_globstar = false;
+        bool literal_last = false;
+        Callback callback;
+    };
+
+    struct Frame {
+        bool is_object;
+        size_t count;           // members or elements read
+        size_t written;         // and kept
+        std::string key;        // name of the current member, unescaped
+    };
+
+    static constexpr size_t kNoComma = static_cast<size_t>(-1);
+    // a streamed input stays buffered from the first byte not yet written, so runs are bounded
+    static constexpr size_t kCopyBytes = 16 * 1024;
+
+    bool Run() {
+        error_ = compiler::ParseError::kNone;
+        error_offset_ = 0;
+        lexer_->SetRawStrings(true);
+        lexer_->SetValidateUtf8(options_.validate_utf8);
+        copied_ = lexer_->Offset();
+        lexer_->Keep(copied_);
+        Token& token = token_;
+        while (true) {
+            if (!Next(&token)) {
+                return false;
+            }
+            if (token.type == compiler::TokenType::kEof) {
+                break;
+            }
+            if (!Document(&token)) {
+                return false;
+            }
+        }
+        Copy(lexer_->Offset());
+        return error_ == compiler::ParseError::kNone;
+    }
+
+    // token starts a top-level value.
+    bool Document(Token* token) {
+        depth_ = 0;
+        if (!Item(token, kNoComma)) {
+            return false;
+        }
+        while (depth_ > 0) {
+            auto frame = &frames_[depth_ - 1];
+            if (!Next(token)) {
+                return false;
+            }
+            auto close = frame->is_object ? compiler::TokenType::kRcurly : compiler::TokenType::kRbrack;
+            if (token->type == close) {
+                Pass(lexer_->Offset());
+                --depth_;
+                continue;
+            }
+            size_t comma = kNoComma;
+            if (frame->count > 0) {
+                if (token->type != compiler::TokenType::kComma) {
+                    return Unexpected(*token);
+                }
+                // held back until it is known whether a member follows in the output
+                comma = token->offset;
+                Pass(comma);
+                if (!Next(token)) {
+                    return false;
+                }
+            }
+            ++frame->count;
+            if (!Item(token, comma)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A member or element starting with token, comma is the offset of the comma before it.
+    bool Item(Token* token, size_t comma) {
+        auto frame = depth_ > 0 ? &frames_[depth_ - 1] : nullptr;
+        size_t key_begin = 0;
+        size_t key_end = 0;
+        if (frame && frame->is_object) {
+            if (token->type != compiler::TokenType::kString) {
+                return Unexpected(*token);
+            }
+            key_begin = token->offset;
+            key_end = lexer_->Offset();
+            frame->key.clear();
+            if (token->escaped) {
+                size_t error_index;
+                Unescape(token->str.data(), token->str.data() + token->str.size(), &frame->key, &error_index);
+            }
+            else {
+                frame->key = token->str;
+            }
+            if (!Next(token)) {
+                return false;
+            }
+            if (token->type != compiler::TokenType::kColon) {
+                return Unexpected(*token);
+            }
+            if (!Next(token)) {
+                return false;
+            }
+        }
+
+        value::ValueType type;
+        switch (token->type) {
+        case compiler::TokenType::kNull: type = value::ValueType::kNull; break;
+        case compiler::TokenType::kTrue:
+        case compiler::TokenType::kFalse: type = value::ValueType::kBoolean; break;
+        case compiler::TokenType::kNumberInt: type = value::ValueType::kNumberInt; break;
+        case compiler::TokenType::kNumberFloat: type = value::ValueType::kNumberFloat; break;
+        case compiler::TokenType::kString: type = value::ValueType::kString; break;
+        case compiler::TokenType::kLbrack: type = value::ValueType::kArray; break;
+        case compiler::TokenType::kLcurly: type = value::ValueType::kObject; break;
+        default:
+            return Unexpected(*token);
+        }
+        bool is_container = type == value::ValueType::kArray || type == value::ValueType::kObject;
+        size_t value_begin = token->offset;
+        size_t value_end = lexer_->Offset();
+
+        edit_.action_ = FieldEdit::Action::kKeep;
+        edit_.renamed_ = false;
+        if (!rules_.empty()) {
+            edit_.key_ = frame && frame->is_object ? StringView(frame->key) : StringView();
+            edit_.index_ = frame ? frame->count - 1 : 0;
+            edit_.is_member_ = frame && frame->is_object;
+            edit_.type_ = type;
+            edit_.raw_ = is_container ? StringView() : lexer_->Text(value_begin, value_end);
+            for (auto& rule : rules_) {
+                if (Matches(rule)) {
+                    rule.callback(&edit_);
+                    if (edit_.action_ != FieldEdit::Action::kKeep) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (edit_.action_ == FieldEdit::Action::kDrop) {
+            Copy(comma != kNoComma ? comma : (frame && frame->is_object ? key_begin : value_begin));
+            return SkipValue(token);
+        }
+        if (comma != kNoComma && frame->written == 0) {
+            // everything before was dropped, so is the comma
+            Copy(comma);
+            Skip(comma + 1);
+        }
+        if (frame) {
+            ++frame->written;
+        }
+        if (edit_.renamed_) {
+            Copy(key_begin);
+            WriteName(edit_.name_);
+            Skip(key_end);
+        }
+        if (edit_.action_ == FieldEdit::Action::kReplace) {
+            Copy(value_begin);
+            Write(edit_.replacement_.data(), edit_.replacement_.size());
+            return SkipValue(token);
+        }
+        Pass(value_end);
+        if (is_container) {
+            if (depth_ >= options_.max_depth) {
+                return Fail(compiler::ParseError::kDepthExceeded, value_begin);
+            }
+            if (depth_ == frames_.size()) {
+                frames_.emplace_back();
+            }
+            auto& opened = frames_[depth_++];
+            opened.is_object = type == value::ValueType::kObject;
+            opened.count = 0;
+            opened.written = 0;
+        }
+        return true;
+    }
+
+    // token starts the value, reads up to its end without writing it.
+    bool SkipValue(Token* token) {
+        size_t depth = 0;
+        while (true) {
+            if (token->type == compiler::TokenType::kLbrack || token->type == compiler::TokenType::kLcurly) {
+                ++depth;
+            }
+            else if (token->type == compiler::TokenType::kRbrack || token->type == compiler::TokenType::kRcurly) {
+                --depth;
+            }
+            else if (token->type == compiler::TokenType::kEof) {
+                return Unexpected(*token);
+            }
+            // nothing of it is needed again, a streamed input can drop it
+            Skip(lexer_->Offset());
+            if (depth == 0) {
+                return true;
+            }
+            if (!Next(token)) {
+                return false;
+            }
+        }
+    }
+
+    bool Matches(const Rule& rule) const {
+        // the last token rules out most values at once
+        if (rule.literal_last && (depth_ == 0 || !TokenMatches(rule.tokens.back(), frames_[depth_ - 1]))) {
+            return false;
+        }
+        if (!rule.has_globstar) {
+            if (rule.tokens.size() != depth_) {
+                return false;
+            }
+            for (size_t i = depth_; i-- > 0;) {
+                if (!TokenMatches(rule.tokens[i], frames_[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return MatchFrom(rule, 0, 0);
+    }
+
+    bool MatchFrom(const Rule& rule, size_t token, size_t level) const {
+        for (; token < rule.tokens.size(); token++, level++) {
+            if (rule.tokens[token] == "**") {
+                for (size_t skip = level; skip <= depth_; skip++) {
+                    if (MatchFrom(rule, token + 1, skip)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            if (level == depth_ || !TokenMatches(rule.tokens[token], frames_[level])) {
+                return false;
+            }
+        }
+        return level == depth_;
+    }
+
+    static bool TokenMatches(const std::string& token, const Frame& frame) {
+        if (token == "*") {
+            return true;
+        }
+        if (frame.is_object) {
+            return token == frame.key;
+        }
+        // decimal index without leading zeros
+        size_t index = frame.count - 1;
+        if (token.empty() || (token[0] == '0' && token.size() > 1)) {
+            return false;
+        }
+        size_t value = 0;
+        for (auto c : token) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            size_t digit = static_cast<size_t>(c - '0');
+            if (value > (std::numeric_limits<size_t>::max() - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+        return value == index;
+    }
+
+    static bool SplitPointer(StringView path, std::vector<std::string>* tokens) {
+        if (path.empty()) {
+            return true;
+        }
+        if (path[0] != '/') {
+            return false;
+        }
+        for (size_t i = 0; i < path.size(); i++) {
+            if (path[i] == '/') {
+                tokens->emplace_back();
+                continue;
+            }
+            auto& token = tokens->back();
+            if (path[i] != '~') {
+                token.push_back(path[i]);
+            }
+            else if (i + 1 < path.size() && (path[i + 1] == '0' || path[i + 1] == '1')) {
+                token.push_back(path[++i] == '0' ? '~' : '/');
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Writes the input up to end.
+    void Copy(size_t end) {
+        if (end > copied_) {
+            auto text = lexer_->Text(copied_, end);
+            Write(text.data(), text.size());
+        }
+        Skip(end);
+    }
+
+    // Input that is kept as it is, copied in long runs.
+    void Pass(size_t end) {
+        if (end - copied_ >= kCopyBytes) {
+            Copy(end);
+        }
+    }
+
+    // Leaves out the input up to end.
+    void Skip(size_t end) noexcept {
+        copied_ = end;
+        lexer_->Keep(end);
+    }
+
+    void Write(const char* data, size_t size) {
+        output_->append(data, size);
+        if (sink_ && output_->size() >= kFlushBytes) {
+            Flush();
+        }
+    }
+
+    void WriteName(const std::string& name) {
+        static const char kHex[] = "0123456789abcdef";
+        output_->push_back('"');
+        for (auto c : name) {
+            if (c == '"' || c == '\\') {
+                output_->push_back('\\');
+                output_->push_back(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                output_->append("\\u00");
+                output_->push_back(kHex[(c >> 4) & 0xF]);
+                output_->push_back(kHex[c & 0xF]);
+            }
+            else {
+                output_->push_back(c);
+            }
+        }
+        output_->push_back('"');
+    }
+
+    bool Flush() {
+        if (!sink_ || output_->empty()) {
+            return error_ == compiler::ParseError::kNone;
+        }
+        if (!sink_->Write(output_->data(), output_->size())) {
+            Fail(compiler::ParseError::kWriteFailed, copied_);
+        }
+        output_->clear();
+        return error_ == compiler::ParseError::kNone;
+    }
+
+    bool Next(Token* token) noexcept {
+        if (error_ != compiler::ParseError::kNone) {
+            // the output failed
+            return false;
+        }
+        if (!lexer_->NextToken(token)) {
+            return Fail(lexer_->Error(), lexer_->ErrorOffset());
+        }
+        return true;
+    }
+
+    bool Unexpected(const Token& token) noexcept {
+        return Fail(token.type == compiler::TokenType::kEof ? compiler::ParseError::kUnexpectedEof : compiler::ParseError::kUnexpectedToken, token.offset);
+    }
+
+    bool Fail(compiler::ParseError error, size_t offset) noexcept {
+        if (error_ == compiler::ParseError::kNone) {
+            error_ = error;
+            error_offset_ = offset;
+        }
+        return false;
+    }
+
+private:
+    compiler::Lexer string_lexer_;
+    compiler::Lexer* lexer_ = nullptr;
+    compiler::ParseOptions options_;
+    std::vector<Rule> rules_;
+    std::vector<Frame> frames_;
+    size_t depth_ = 0;
+    Token token_;
+    FieldEdit edit_;
+    size_t copied_ = 0;         // the input before it has been written or left out
+    std::string* output_ = nullptr;
+    std::string buffer_;
+    OutputSink* sink_ = nullptr;
+    compiler::ParseError error_ = compiler::ParseError::kNone;
+    size_t error_offset_ = 0;
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_STREAM_TRANSFORMER_HPP_
@@ -0,0 +1,146 @@
+#ifndef YUJSON_STRING_VIEW_HPP_
+#define YUJSON_STRING_VIEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace yuJson {
+
+// Minimal C++14 stand-in for std::string_view, used for allocation free key lookups.
+class StringView {
+public:
+    constexpr StringView() noexcept : data_(""), size_(0) { }
+    constexpr StringView(const char* data, size_t size) noexcept : data_(data), size_(size) { }
+    StringView(const char* str) noexcept : data_(str), size_(std::strlen(str)) { }
+    template <typename Allocator>
+    StringView(const std::basic_string<char, std::char_traits<char>, Allocator>& str) noexcept : data_(str.data()), size_(str.size()) { }
+
+public:
+    constexpr const char* data() const noexcept {
+        return data_;
+    }
+
+    constexpr size_t size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr char operator[](size_t index) const noexcept {
+        return data_[index];
+    }
+
+    constexpr const char* begin() const noexcept {
+        return data_;
+    }
+
+    constexpr const char* end() const noexcept {
+        return data_ + size_;
+    }
+
+    int compare(StringView other) const noexcept {
+        int result = std::char_traits<char>::compare(data_, other.data_, size_ < other.size_ ? size_ : other.size_);
+        if (result != 0) {
+            return result;
+        }
+        return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+    }
+
+    std::string ToString() const {
+        return std::string(data_, size_);
+    }
+
+    friend bool operator==(StringView a, StringView b) noexcept {
+        return a.size_ == b.size_ && std::char_traits<char>::compare(a.data_, b.data_, a.size_) == 0;
+    }
+
+    friend bool operator!=(StringView a, StringView b) noexcept {
+        return !(a == b);
+    }
+
+    friend bool operator<(StringView a, StringView b) noexcept {
+        return a.compare(b) < 0;
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+};
+
+/*
+* A key prepared once and looked up many times, e.g. a static constexpr Key kId("id").
+* Caches the length, so no strlen and no std::string is built per lookup,
+* and a 64 bit FNV-1a hash for the hashed key tables of frozen documents.
+* The characters are not copied, the Key must not outlive them.
+*/
+class Key {
+public:
+    template <size_t N>
+    constexpr Key(const char (&str)[N]) noexcept : view_(str, N - 1), hash_(Hash(str, N - 1)) { }
+    constexpr Key(const char* data, size_t size) noexcept : view_(data, size), hash_(Hash(data, size)) { }
+    explicit Key(StringView view) noexcept : view_(view), hash_(Hash(view.data(), view.size())) { }
+
+public:
+    constexpr StringView View() const noexcept {
+        return view_;
+    }
+
+    constexpr operator StringView() const noexcept {
+        return view_;
+    }
+
+    constexpr size_t size() const noexcept {
+        return view_.size();
+    }
+
+    constexpr uint64_t Hash() const noexcept {
+        return hash_;
+    }
+
+    static constexpr uint64_t Hash(const char* data, size_t size) noexcept {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+private:
+    StringView view_;
+    uint64_t hash_;
+};
+
+// Transparent ordering for the object map, lets find take a StringView or a Key without building a std::string.
+struct KeyLess {
+    using is_transparent = void;
+
+    bool operator()(const std::string& a, const std::string& b) const noexcept {
+        return a < b;
+    }
+    bool operator()(const std::string& a, StringView b) const noexcept {
+        return StringView(a).compare(b) < 0;
+    }
+    bool operator()(StringView a, const std::string& b) const noexcept {
+        return a.compare(StringView(b)) < 0;
+    }
+    bool operator()(const std::string& a, const char* b) const noexcept {
+        return a.compare(b) < 0;
+    }
+    bool operator()(const char* a, const std::string& b) const noexcept {
+        return b.compare(a) > 0;
+    }
+    bool operator()(const std::string& a, const Key& b) const noexcept {
+        return StringView(a).compare(b.View()) < 0;
+    }
+    bool operator()(const Key& a, const std::string& b) const noexcept {
+        return a.View().compare(StringView(b)) < 0;
+    }
+};
+
+} // namespace yuJson
+
+#endif // YUJSON_STRING_VIEW_HPP_
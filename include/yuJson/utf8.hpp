@@ -0,0 +1,264 @@
+#ifndef YUJSON_UTF8_HPP_
+#define YUJSON_UTF8_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace yuJson {
+namespace utf8 {
+
+// Offset of the first byte that is not ASCII, size if there is none.
+inline size_t SkipAscii(const char* data, size_t size) noexcept {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (_mm256_movemask_epi8(block) != 0) {
+            break;
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 16 <= size; i += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(block) != 0) {
+            break;
+        }
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        if (word & 0x8080808080808080ull) {
+            break;
+        }
+    }
+    while (i < size && static_cast<unsigned char>(data[i]) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// Byte by byte check of the well-formed sequences in Unicode table 3-7, returns the offset of the first bad sequence.
+inline size_t ValidateScalar(const char* data, size_t size) noexcept {
+    auto bytes = reinterpret_cast<const unsigned char*>(data);
+    auto is_cont = [&](size_t i, unsigned char min = 0x80, unsigned char max = 0xbf) {
+        return i < size && bytes[i] >= min && bytes[i] <= max;
+    };
+    size_t i = 0;
+    while (i < size) {
+        i += SkipAscii(data + i, size - i);
+        if (i >= size) {
+            break;
+        }
+        auto c = bytes[i];
+        size_t length;
+        if (c >= 0xc2 && c <= 0xdf) {
+            length = is_cont(i + 1) ? 2 : 0;
+        }
+        else if (c >= 0xe0 && c <= 0xef) {
+            unsigned char min = c == 0xe0 ? 0xa0 : 0x80;
+            unsigned char max = c == 0xed ? 0x9f : 0xbf;
+            length = is_cont(i + 1, min, max) && is_cont(i + 2) ? 3 : 0;
+        }
+        else if (c >= 0xf0 && c <= 0xf4) {
+            unsigned char min = c == 0xf0 ? 0x90 : 0x80;
+            unsigned char max = c == 0xf4 ? 0x8f : 0xbf;
+            length = is_cont(i + 1, min, max) && is_cont(i + 2) && is_cont(i + 3) ? 4 : 0;
+        }
+        else {
+            length = 0;
+        }
+        if (length == 0) {
+            return i;
+        }
+        i += length;
+    }
+    return size;
+}
+
+#if defined(__AVX2__)
+/*
+* Lookup table validation after Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte".
+* Three nibble lookups classify every pair of adjacent bytes, lengths of 3 and 4 byte sequences are checked
+* with saturating subtractions, 32 bytes per step.
+*/
+class Avx2Checker {
+public:
+    // Feeds the next 32 bytes, returns false once an error is seen in them or the bytes before.
+    bool Check(__m256i input) noexcept {
+        if (_mm256_movemask_epi8(input) == 0) {
+            // an ASCII block only has to close what the previous block started
+            error_ = _mm256_or_si256(error_, prev_incomplete_);
+            prev_incomplete_ = _mm256_setzero_si256();
+        }
+        else {
+            auto prev1 = Prev<1>(input);
+            auto special = CheckSpecialCases(input, prev1);
+            error_ = _mm256_or_si256(error_, CheckMultibyteLengths(input, special));
+            prev_incomplete_ = IsIncomplete(input);
+        }
+        prev_input_ = input;
+        return _mm256_testz_si256(error_, error_);
+    }
+
+    // True if the input did not stop inside a sequence.
+    bool Finish() noexcept {
+        error_ = _mm256_or_si256(error_, prev_incomplete_);
+        return _mm256_testz_si256(error_, error_);
+    }
+
+private:
+    static constexpr uint8_t kTooShort = 1 << 0;
+    static constexpr uint8_t kTooLong = 1 << 1;
+    static constexpr uint8_t kOverlong3 = 1 << 2;
+    static constexpr uint8_t kTooLarge = 1 << 3;
+    static constexpr uint8_t kSurrogate = 1 << 4;
+    static constexpr uint8_t kOverlong2 = 1 << 5;
+    static constexpr uint8_t kTooLarge1000 = 1 << 6;
+    static constexpr uint8_t kOverlong4 = 1 << 6;
+    static constexpr uint8_t kTwoConts = 1 << 7;
+    static constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+    template <int N>
+    __m256i Prev(__m256i input) const noexcept {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input_, input, 0x21), 16 - N);
+    }
+
+    static __m256i Lookup(__m256i nibbles, __m256i table) noexcept {
+        return _mm256_shuffle_epi8(table, nibbles);
+    }
+
+    static __m256i High(__m256i input) noexcept {
+        return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0f));
+    }
+
+    static __m256i Table(uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3, uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t v10, uint8_t v11, uint8_t v12, uint8_t v13, uint8_t v14, uint8_t v15) noexcept {
+        return _mm256_setr_epi8(v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15,
+            v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15);
+    }
+
+    static __m256i CheckSpecialCases(__m256i input, __m256i prev1) noexcept {
+        auto byte_1_high = Lookup(High(prev1), Table(
+            // 0_______ ________ ascii in byte 1
+            kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+            // 10______ ________ continuation in byte 1
+            kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+            // 1100____ ________ two byte lead
+            kTooShort | kOverlong2,
+            // 1101____ ________ two byte lead
+            kTooShort,
+            // 1110____ ________ three byte lead
+            kTooShort | kOverlong3 | kSurrogate,
+            // 1111____ ________ four byte lead
+            kTooShort | kTooLarge | kTooLarge1000 | kOverlong4));
+        auto byte_1_low = Lookup(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)), Table(
+            // ____0000 ________
+            kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+            // ____0001 ________
+            kCarry | kOverlong2,
+            // ____001_ ________
+            kCarry, kCarry,
+            // ____0100 ________
+            kCarry | kTooLarge,
+            // ____0101 ________ and above
+            kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+            kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+            kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+            // ____1101 ________
+            kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+            kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000));
+        auto byte_2_high = Lookup(High(input), Table(
+            // ________ 0_______ ascii in byte 2
+            kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+            // ________ 1000____
+            kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+            // ________ 1001____
+            kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+            // ________ 101_____
+            kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+            kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+            // ________ 11______
+            kTooShort, kTooShort, kTooShort, kTooShort));
+        return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+    }
+
+    __m256i CheckMultibyteLengths(__m256i input, __m256i special) const noexcept {
+        // only 111_____ two bytes back or 1111____ three bytes back reach 0x80 after the subtraction
+        auto is_third_byte = _mm256_subs_epu8(Prev<2>(input), _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+        auto is_fourth_byte = _mm256_subs_epu8(Prev<3>(input), _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+        auto must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+        return _mm256_xor_si256(must_be_continuation, special);
+    }
+
+    static __m256i IsIncomplete(__m256i input) noexcept {
+        const auto max_value = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+        return _mm256_subs_epu8(input, max_value);
+    }
+
+private:
+    __m256i error_ = _mm256_setzero_si256();
+    __m256i prev_input_ = _mm256_setzero_si256();
+    __m256i prev_incomplete_ = _mm256_setzero_si256();
+};
+#endif
+
+} // namespace utf8
+
+/*
+* Checks that data is well-formed UTF-8, *error_offset receives the start of the first bad sequence.
+* Runs 32 bytes per step with AVX2 (build with -mavx2 or YUJSON_ENABLE_AVX2), otherwise skips ASCII
+* 16 or 8 bytes at a time and checks the rest byte by byte.
+*/
+inline bool ValidateUtf8(const char* data, size_t size, size_t* error_offset = nullptr) noexcept {
+    size_t offset;
+#if defined(__AVX2__)
+    utf8::Avx2Checker checker;
+    size_t i = 0;
+    bool valid = true;
+    for (; i + 32 <= size; i += 32) {
+        if (!checker.Check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)))) {
+            valid = false;
+            break;
+        }
+    }
+    if (valid) {
+        // the tail is padded with ASCII, which also flags a sequence cut off by the end
+        char tail[32] = {};
+        std::memcpy(tail, data + i, size - i);
+        valid = checker.Check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail))) && checker.Finish();
+        if (valid) {
+            return true;
+        }
+    }
+    // locate the error byte by byte, starting at the sequence that may begin up to 3 bytes before the block
+    size_t restart = i >= 3 ? i - 3 : 0;
+    while (restart > 0 && (static_cast<unsigned char>(data[restart]) & 0xc0) == 0x80) {
+        --restart;
+    }
+    offset = restart + utf8::ValidateScalar(data + restart, size - restart);
+#else
+    offset = utf8::ValidateScalar(data, size);
+#endif
+    if (offset == size) {
+        return true;
+    }
+    if (error_offset) {
+        *error_offset = offset;
+    }
+    return false;
+}
+
+} // namespace yuJson
+
+#endif // YUJSON_UTF8_HPP_
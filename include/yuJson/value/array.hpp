@@ -12,7 +12,7 @@ class ArrayValue : public ValueInterface {
 public:
     ArrayValue() noexcept { }
     ArrayValue(ArrayValue&& arr) noexcept : arr_(std::move(arr.arr_)) { }
-    ~ArrayValue() noexcept { }
+    ~ArrayValue() noexcept;
 
     ArrayValue(const ArrayValue&) = delete;
     void operator=(const ArrayValue&) = delete;
@@ -36,10 +36,26 @@ public:
         arr_.push_back(std::move(value));
     }
 
+    void Reserve(size_t capacity) {
+        arr_.reserve(capacity);
+    }
+
+    size_t Capacity() const noexcept {
+        return arr_.capacity();
+    }
+
     void Set(int i, ValuePtr value) noexcept {
         arr_[i] = std::move(value);
     }
 
+    void Insert(int i, ValuePtr value) {
+        arr_.insert(arr_.begin() + i, std::move(value));
+    }
+
+    void Erase(int i) noexcept {
+        arr_.erase(arr_.begin() + i);
+    }
+
 private:
     ValuePtrVector arr_;
 };
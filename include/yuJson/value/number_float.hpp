@@ -1,6 +1,9 @@
 #ifndef YUJSON_VALUE_NUMBER_FLOAT_HPP_
 #define YUJSON_VALUE_NUMBER_FLOAT_HPP_
 
+#include <atomic>
+#include <cstdlib>
+
 #include <yuJson/value/value.hpp>
 
 namespace yuJson {
@@ -15,21 +18,80 @@ public:
         return ValueType::kNumberFloat;
     }
 
-    double& Get() noexcept {
-        return float_;
+    // Converts the input text on first use, safe to call from several threads.
+    double Get() const noexcept {
+        if (state_.load(std::memory_order_acquire) == kDecoded) {
+            return float_;
+        }
+        double num = Decode();
+        uint8_t expected = kRaw;
+        if (state_.compare_exchange_strong(expected, kDecoding, std::memory_order_acquire)) {
+            float_ = num;
+            state_.store(kDecoded, std::memory_order_release);
+        }
+        // a thread that loses the claim has the same value already
+        return num;
     }
 
     void Set(double num) noexcept {
         float_ = num;
+        state_.store(kDecoded, std::memory_order_relaxed);
+        has_raw_ = false;
+    }
+
+    bool HasRaw() const noexcept {
+        return has_raw_;
+    }
+
+    // The digits as they appeared in the input, empty unless parsed with ParseOptions::lazy_numbers.
+    StringView Raw() const noexcept;
+
+protected:
+    // Only RawNumberFloatValue starts undecoded.
+    NumberFloatValue() noexcept : float_(0), state_(kRaw), has_raw_(true) { }
+
+private:
+    double Decode() const noexcept {
+        return std::strtod(Raw().data(), nullptr);
     }
 
 private:
-    double float_;
+    enum : uint8_t {
+        kRaw,
+        kDecoding,
+        kDecoded,
+    };
+
+    mutable double float_;
+    mutable std::atomic<uint8_t> state_{ kDecoded };
+    bool has_raw_ = false;
 };
 
+// A float that keeps its input text and converts it on the first Get.
+class RawNumberFloatValue : public NumberFloatValue {
+public:
+    explicit RawNumberFloatValue(StringView raw) : raw_(raw.data(), raw.size()) { }
+
+    ~RawNumberFloatValue() noexcept { }
+
+    const String& GetRaw() const noexcept {
+        return raw_;
+    }
+
+private:
+    String raw_;
+};
+
+inline StringView NumberFloatValue::Raw() const noexcept {
+    if (!has_raw_) {
+        return StringView();
+    }
+    return StringView(static_cast<const RawNumberFloatValue*>(this)->GetRaw());
+}
+
 using NumberFloatPtr = std::unique_ptr<NumberFloatValue>;
 
 } // namespace value
 } // namespace yuJson
 
-#endif // YUJSON_VALUE_NUMBER_FLOAT_HPP_
\ No newline at end of file
+#endif // YUJSON_VALUE_NUMBER_FLOAT_HPP_
@@ -1,6 +1,9 @@
 #ifndef YUJSON_VALUE_NUMBER_INT_HPP_
 #define YUJSON_VALUE_NUMBER_INT_HPP_
 
+#include <atomic>
+#include <cstdlib>
+
 #include <yuJson/value/value.hpp>
 
 namespace yuJson {
@@ -16,20 +19,88 @@ public:
         return ValueType::kNumberInt;
     }
 
-    int64_t& Get() noexcept {
-        return int_;
+    // Converts the input text on first use, safe to call from several threads.
+    int64_t Get() const noexcept {
+        if (state_.load(std::memory_order_acquire) == kDecoded) {
+            return int_;
+        }
+        int64_t num = Decode();
+        uint8_t expected = kRaw;
+        if (state_.compare_exchange_strong(expected, kDecoding, std::memory_order_acquire)) {
+            int_ = num;
+            state_.store(kDecoded, std::memory_order_release);
+        }
+        // a thread that loses the claim has the same value already
+        return num;
     }
 
     void Set(int64_t num) noexcept {
         int_ = num;
+        state_.store(kDecoded, std::memory_order_relaxed);
+        has_raw_ = false;
+    }
+
+    // Exact for the whole 0 ~ 2^64-1 range when the input text is kept.
+    uint64_t GetUint64() noexcept {
+        if (has_raw_ && Raw()[0] != '-') {
+            return std::strtoull(Raw().data(), nullptr, 10);
+        }
+        return static_cast<uint64_t>(Get());
     }
 
+    bool HasRaw() const noexcept {
+        return has_raw_;
+    }
+
+    // The digits as they appeared in the input, empty unless parsed with ParseOptions::lazy_numbers.
+    StringView Raw() const noexcept;
+
+protected:
+    // Only RawNumberIntValue starts undecoded.
+    NumberIntValue() noexcept : int_(0), state_(kRaw), has_raw_(true) { }
+
 private:
-    int64_t int_;
+    // Out of range values saturate, GetUint64 and Raw stay exact.
+    int64_t Decode() const noexcept {
+        return std::strtoll(Raw().data(), nullptr, 10);
+    }
+
+private:
+    enum : uint8_t {
+        kRaw,
+        kDecoding,
+        kDecoded,
+    };
+
+    mutable int64_t int_;
+    mutable std::atomic<uint8_t> state_{ kDecoded };
+    bool has_raw_ = false;
 };
 
+// An integer that keeps its input text and converts it on the first Get.
+class RawNumberIntValue : public NumberIntValue {
+public:
+    explicit RawNumberIntValue(StringView raw) : raw_(raw.data(), raw.size()) { }
+
+    ~RawNumberIntValue() noexcept { }
+
+    const String& GetRaw() const noexcept {
+        return raw_;
+    }
+
+private:
+    String raw_;
+};
+
+inline StringView NumberIntValue::Raw() const noexcept {
+    if (!has_raw_) {
+        return StringView();
+    }
+    return StringView(static_cast<const RawNumberIntValue*>(this)->GetRaw());
+}
+
 using NumberIntPtr = std::unique_ptr<NumberIntValue>;
 } // namespace value
 } // namespace yuJson
 
-#endif // YUJSON_VALUE_NUMBER_INT_HPP_
\ No newline at end of file
+#endif // YUJSON_VALUE_NUMBER_INT_HPP_
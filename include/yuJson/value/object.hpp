@@ -12,7 +12,7 @@ class ObjectValue : public ValueInterface {
 public:
     ObjectValue() noexcept { }
     ObjectValue(ObjectValue&& obj) noexcept : obj_(std::move(obj.obj_)) { }
-    ~ObjectValue() noexcept { }
+    ~ObjectValue() noexcept;
 
     ObjectValue(const ObjectValue&) = delete;
     void operator=(const ObjectValue&) = delete;
@@ -25,15 +25,24 @@ public:
         return obj_;
     }
 
-    ValuePtr& At(const std::string& key) {
-        return obj_.at(key);
+    ValuePtr& At(StringView key) {
+        auto iter = obj_.find(key);
+        if (iter == obj_.end()) {
+            YUJSON_THROW(std::out_of_range("Key does not exist"));
+        }
+        return iter->second;
     }
 
-    ValuePtr& operator[](const std::string& key) {
-        return obj_[key];
+    // Only inserting a new member allocates the key.
+    ValuePtr& operator[](StringView key) {
+        auto iter = obj_.lower_bound(key);
+        if (iter == obj_.end() || StringView(iter->first) != key) {
+            iter = obj_.emplace_hint(iter, std::string(key.data(), key.size()), nullptr);
+        }
+        return iter->second;
     }
 
-    bool Exist(const std::string& key) noexcept {
+    bool Exist(StringView key) noexcept {
         return obj_.find(key) != obj_.end();
     }
 
@@ -42,8 +51,17 @@ public:
         it = std::move(value);
     }
 
-    void Delete(const std::string& key) noexcept {
-        obj_.erase(key);
+    // The key is moved into the new node, an existing member is overwritten.
+    void Set(std::string&& key, ValuePtr value) {
+        auto& it = obj_.operator[](std::move(key));
+        it = std::move(value);
+    }
+
+    void Delete(StringView key) noexcept {
+        auto iter = obj_.find(key);
+        if (iter != obj_.end()) {
+            obj_.erase(iter);
+        }
     }
 
 private:
@@ -1,17 +1,27 @@
 #ifndef YUJSON_VALUE_STRING_HPP_
 #define YUJSON_VALUE_STRING_HPP_
 
+#include <atomic>
+#include <thread>
+
 #include <yuJson/value/value.hpp>
+#include <yuJson/escape.hpp>
 
 namespace yuJson {
 namespace value {
 class StringValue : public ValueInterface {
 public:
-    explicit StringValue(const std::string& str) : str_(str) { }
-    StringValue(StringValue&& str) noexcept : str_(str.Get()) { }
+    explicit StringValue(const char* str) : str_(str) { }
+    explicit StringValue(const std::string& str) : str_(str.data(), str.size()) { }
+    explicit StringValue(const String& str) : str_(str.data(), str.size()) { }
+    explicit StringValue(String&& str) noexcept : str_(std::move(str)) { }
+    StringValue(const char* str, size_t size) : str_(str, size) { }
+    StringValue(StringValue&& str) noexcept : str_(std::move(str.GetMutable())) { }
 
     void operator=(StringValue&& str) noexcept {
-        this->str_ = std::move(str.Get());
+        this->str_ = std::move(str.GetMutable());
+        raw_ = false;
+        escaped_ = false;
     }
 
     ~StringValue() noexcept { }
@@ -20,16 +30,98 @@ public:
         return ValueType::kString;
     }
 
-    std::string& Get() noexcept {
+    // A raw string stays raw, escaped ones are decoded once into a cache. Safe to call from several threads.
+    const String& Get() const;
+
+    // For changing the string in place, a raw string is decoded and printed escaped from then on.
+    String& GetMutable() {
+        if (raw_) {
+            Materialize();
+        }
+        return str_;
+    }
+
+    // The body as written in the input, only meaningful while IsRaw.
+    bool IsRaw() const noexcept {
+        return raw_;
+    }
+
+    bool IsEscaped() const noexcept {
+        return escaped_;
+    }
+
+    const String& Raw() const noexcept {
         return str_;
     }
 
+protected:
+    StringValue(StringView raw, bool escaped) : str_(raw.data(), raw.size()), raw_(true), escaped_(escaped) { }
+
+private:
+    void Materialize() {
+        if (escaped_) {
+            str_ = Get();
+        }
+        raw_ = false;
+        escaped_ = false;
+    }
+
+private:
+    String str_;
+    bool raw_ = false;
+    bool escaped_ = false;
+};
+
+// A string body kept as written in the input, see ParseOptions::lazy_strings.
+class RawStringValue : public StringValue {
+public:
+    RawStringValue(StringView raw, bool escaped) : StringValue(raw, escaped), decoded_(Raw().get_allocator()) { }
+
+    ~RawStringValue() noexcept { }
+
+    const String& Decoded() const {
+        if (state_.load(std::memory_order_acquire) == kDecoded) {
+            return decoded_;
+        }
+        // decoded before claiming, so an allocation failure leaves nothing half done
+        String decoded(Raw().get_allocator());
+        decoded.reserve(Raw().size());
+        size_t error_index;
+        // the lexer has checked the escapes
+        Unescape(Raw().data(), Raw().data() + Raw().size(), &decoded, &error_index);
+        uint8_t expected = kRaw;
+        if (state_.compare_exchange_strong(expected, kDecoding, std::memory_order_acquire)) {
+            decoded_ = std::move(decoded);
+            state_.store(kDecoded, std::memory_order_release);
+            return decoded_;
+        }
+        // another thread got there first, it only has a move left to do
+        while (state_.load(std::memory_order_acquire) != kDecoded) {
+            std::this_thread::yield();
+        }
+        return decoded_;
+    }
+
 private:
-    std::string str_;
+    enum : uint8_t {
+        kRaw,
+        kDecoding,
+        kDecoded,
+    };
+
+    mutable String decoded_;
+    mutable std::atomic<uint8_t> state_{ kRaw };
 };
 
+inline const String& StringValue::Get() const {
+    if (escaped_) {
+        return static_cast<const RawStringValue*>(this)->Decoded();
+    }
+    return str_;
+}
+
 using StringPtr = std::unique_ptr<StringValue>;
 } // namespace value
 } // namespace yuJson
 
-#endif // YUJSON_VALUE_STRING_HPP_
\ No newline at end of file
+#endif // YUJSON_VALUE_STRING_HPP_
@@ -2,6 +2,16 @@
 #define YUJSON_VALUE_VALUE_HPP_
 
 #include <stdexcept>
+#include <cstdlib>
+
+#include <yuJson/memory_resource.hpp>
+#include <yuJson/string_view.hpp>
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define YUJSON_THROW(exception) throw exception
+#else
+#define YUJSON_THROW(exception) std::abort()
+#endif
 
 namespace yuJson {
 namespace value {
@@ -40,6 +50,25 @@ protected:
 public:
     virtual ~ValueInterface() noexcept { }
 
+public:
+    // Nodes come from the default resource of the creating thread, the resource is stored in front of the node.
+    static void* operator new(size_t size) {
+        auto resource = GetDefaultResource();
+        auto block = static_cast<char*>(resource->Allocate(size + kNodeHeader));
+        *reinterpret_cast<MemoryResource**>(block) = resource;
+        return block + kNodeHeader;
+    }
+
+    static void operator delete(void* ptr, size_t size) noexcept {
+        if (!ptr) {
+            return;
+        }
+        auto block = static_cast<char*>(ptr) - kNodeHeader;
+        (*reinterpret_cast<MemoryResource**>(block))->Deallocate(block, size + kNodeHeader);
+    }
+
+    static constexpr size_t kNodeHeader = alignof(std::max_align_t);
+
 public:
     virtual ValueType Type() const noexcept = 0;
 
@@ -54,7 +83,7 @@ public:
 
     NullValue& ToNull() {
         if (!IsNull()) {
-            throw ValueTypeError("Not Null data");
+            YUJSON_THROW(ValueTypeError("Not Null data"));
         }
         return *reinterpret_cast<NullValue*>(this);
     }
@@ -66,7 +95,7 @@ public:
 
     BooleanValue& ToBoolean() {
         if (!IsBoolean()) {
-            throw ValueTypeError("Not Boolean data");
+            YUJSON_THROW(ValueTypeError("Not Boolean data"));
         }
         return GetBoolean();
     }
@@ -81,14 +110,14 @@ public:
 
     NumberIntValue& ToNumberInt() {
         if (!IsNumberInt()) {
-            throw ValueTypeError("Not Number data");
+            YUJSON_THROW(ValueTypeError("Not Number data"));
         }
         return GetNumberInt();
     }
 #ifndef YUJSON_DISABLE_FLOAT
     NumberFloatValue& ToNumberFloat() {
         if (!IsNumberFloat()) {
-            throw ValueTypeError("Not Number data");
+            YUJSON_THROW(ValueTypeError("Not Number data"));
         }
         return GetNumberFloat();
     }
@@ -99,7 +128,7 @@ public:
 
     StringValue& ToString() {
         if (!IsString()) {
-            throw ValueTypeError("Not String data");
+            YUJSON_THROW(ValueTypeError("Not String data"));
         }
         return GetString();
     }
@@ -110,7 +139,7 @@ public:
 
     ArrayValue& ToArray() {
         if (!IsArray()) {
-            throw ValueTypeError("Not Array data");
+            YUJSON_THROW(ValueTypeError("Not Array data"));
         }
         return GetArray();
     }
@@ -121,7 +150,7 @@ public:
 
     ObjectValue& ToObject() {
         if (!IsObject()) {
-            throw ValueTypeError("Not Object data");
+            YUJSON_THROW(ValueTypeError("Not Object data"));
         }
         return GetObject();
     }
@@ -159,6 +188,8 @@ public:
 } // namespace yuJson
 
 
+#include <new>
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
@@ -167,8 +198,9 @@ namespace yuJson{
 namespace value{
 
 using ValuePtr = std::unique_ptr<ValueInterface>;
-using ValuePtrVector = std::vector<ValuePtr>;
-using ValuePtrtMap = std::map<std::string, ValuePtr>;
+using ValuePtrVector = std::vector<ValuePtr, Allocator<ValuePtr>>;
+using ValuePtrtMap = std::map<std::string, ValuePtr, KeyLess, Allocator<std::pair<const std::string, ValuePtr>>>;
+using String = std::basic_string<char, std::char_traits<char>, Allocator<char>>;
 
 }
 }
@@ -183,4 +215,151 @@ using ValuePtrtMap = std::map<std::string, ValuePtr>;
 #include <yuJson/value/string.hpp>
 #include <yuJson/value/array.hpp>
 #include <yuJson/value/object.hpp>
+
+namespace yuJson {
+namespace value {
+
+// Scratch stack of DestroyChildren. It grows with nothrow allocations, so a destructor never has to throw.
+class PendingStack {
+public:
+    PendingStack() noexcept { }
+    ~PendingStack() noexcept {
+        ::operator delete(data_);
+    }
+
+    PendingStack(const PendingStack&) = delete;
+    void operator=(const PendingStack&) = delete;
+
+    // Takes ownership of value, false when the stack could not grow.
+    bool Push(ValueInterface* value) noexcept {
+        if (size_ == capacity_ && !Grow()) {
+            return false;
+        }
+        data_[size_++] = value;
+        return true;
+    }
+
+    ValuePtr Pop() noexcept {
+        return ValuePtr(data_[--size_]);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Frees the buffer of an empty stack that has grown beyond max_capacity entries.
+    void Trim(size_t max_capacity) noexcept {
+        if (size_ == 0 && capacity_ > max_capacity) {
+            ::operator delete(data_);
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+    }
+
+private:
+    bool Grow() noexcept {
+        size_t capacity = capacity_ ? capacity_ * 2 : 64;
+        auto data = static_cast<ValueInterface**>(::operator new(capacity * sizeof(ValueInterface*), std::nothrow));
+        if (!data) {
+            return false;
+        }
+        std::copy(data_, data_ + size_, data);
+        ::operator delete(data_);
+        data_ = data;
+        capacity_ = capacity;
+        return true;
+    }
+
+private:
+    ValueInterface** data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Moves the container children of value into pending, leaving only scalars behind.
+// A child the stack has no room for is freed on the spot, recursing through its own subtree.
+inline void DetachContainers(ValueInterface* value, PendingStack* pending) noexcept {
+    auto detach = [pending](ValuePtr& child) {
+        if (child && (child->IsArray() || child->IsObject())) {
+            if (pending->Push(child.get())) {
+                child.release();
+            }
+            else {
+                child.reset();
+            }
+        }
+    };
+    if (value->IsArray()) {
+        for (auto& child : value->GetArray().GetVector()) {
+            detach(child);
+        }
+    }
+    else if (value->IsObject()) {
+        for (auto& child : value->GetObject().GetMap()) {
+            detach(child.second);
+        }
+    }
+}
+
+// The PendingStack of DestroyChildren, kept per thread so that freeing documents stops allocating once it has grown.
+// Up to kRetained entries survive a document, the peak of a larger one is given back when it is done.
+// Documents freed after the thread_local objects of their thread, e.g. globals at exit, get nullptr.
+class DestroyStack {
+public:
+    static constexpr size_t kRetained = 64 * 1024;
+
+
+    ~DestroyStack() noexcept {
+        Alive() = false;
+    }
+
+    static PendingStack* Get() noexcept {
+        thread_local DestroyStack stack;
+        return Alive() ? &stack.pending_ : nullptr;
+    }
+
+private:
+    DestroyStack() noexcept {
+        Alive() = true;
+    }
+
+    static bool& Alive() noexcept {
+        thread_local bool alive = false;
+        return alive;
+    }
+
+    PendingStack pending_;
+};
+
+// Frees the subtree of a container without recursion: every nested container is detached
+// before it is freed, so its own destructor only finds scalars.
+// A nested call only works above the entries of the outer one on the shared stack.
+inline void DestroyChildren(ValueInterface* value) noexcept {
+    PendingStack local;
+    auto pending = DestroyStack::Get();
+    if (!pending) {
+        pending = &local;
+    }
+    auto base = pending->Size();
+    DetachContainers(value, pending);
+    while (pending->Size() > base) {
+        auto node = pending->Pop();
+        DetachContainers(node.get(), pending);
+    }
+    if (base == 0) {
+        pending->Trim(DestroyStack::kRetained);
+    }
+}
+
+inline ArrayValue::~ArrayValue() noexcept {
+    DestroyChildren(this);
+}
+
+inline ObjectValue::~ObjectValue() noexcept {
+    DestroyChildren(this);
+}
+
+} // namespace value
+} // namespace yuJson
+
 #endif // YUJSON_VALUE_VALUE_HPP_
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <iostream>
+#include <sstream>
 #include <yuJson/json.hpp>
+#include <yuJson/parser_context.hpp>
 
 class A {
 public:
@@ -112,4 +114,387 @@ int main() {
     for (auto& sub_json : json) {
         std::cout << sub_json.value().Print() << std::endl << std::endl;
     }
+
+
+    /*
+    * patch
+    */
+    auto patch_src = Json::Parse(R"({"a": 1, "b": [1, 2, 3, 4], "c": {"d": "x", "e": false}})");
+    auto patch_dst = Json::Parse(R"({"a": 1, "b": [1, 5, 4], "c": {"d": "y"}, "f/g": null})");
+    auto patch = Json::Diff(patch_src, patch_dst);
+    std::cout << patch.Print(false) << std::endl << std::endl;
+
+    patch_src.ApplyPatch(std::move(patch));
+    std::cout << (patch_src == patch_dst ? "patch applied" : "patch failed") << std::endl;
+    std::cout << patch_src.ApplyPatch(Json::Parse(R"([{"op": "remove", "path": "/b/18446744073709551616"}])")) << " " << patch_src["b"].Print(false) << std::endl << std::endl;
+
+    patch_src.ApplyPatch(Json::Parse(R"([{"op": "move", "from": "/b/0", "path": "/c/h"}, {"op": "copy", "from": "/c", "path": "/i"}, {"op": "test", "path": "/i/h", "value": 1}])"));
+    std::cout << patch_src.Print(false) << std::endl << std::endl;
+
+    patch_src.ApplyMergePatch(Json::Parse(R"({"a": null, "c": {"d": "z", "h": null}, "i": [1]})"));
+    std::cout << patch_src.Print(false) << std::endl << std::endl;
+
+    /*
+    * parallel print
+    */
+    Json big_arr = Json::Array();
+    for (int i = 0; i < 5000; i++) {
+        big_arr.push_back({ "id", i, "tags", Json::Array({ "a", "b/c" }) });
+    }
+    std::cout << (big_arr.Print() == big_arr.PrintParallel(true, 4) ? "identical" : "different") << std::endl;
+    Json wrapped = { "rows", Json::Parse(big_arr.Print()), "count", 5000 };
+    std::cout << (wrapped.Print() == wrapped.PrintParallel(true, 4) ? "identical" : "different") << std::endl << std::endl;
+
+    /*
+    * parallel parse
+    */
+    auto big_text = big_arr.Print(false);
+    while (big_text.size() < 2 * 1024 * 1024) {
+        big_text.insert(big_text.size() - 1, ", " + big_arr.Print(false));
+    }
+    auto big_parsed = Json::ParseParallel(big_text, 4);
+    std::cout << (big_parsed == Json::Parse(big_text) ? "identical" : "different") << std::endl;
+    std::string big_string(1200 * 1024, 'x');
+    std::cout << Json::ParseParallel("[\"" + big_string + "\",]", 2).IsValid()
+        << Json::ParseParallel("{\"a\": \"" + big_string + "\", }", 2).IsValid()
+        << Json::ParseParallel("[\"" + big_string + "\", 1]", 2).IsValid() << std::endl << std::endl;
+
+    /*
+    * stats, only collected with YUJSON_ENABLE_STATS
+    */
+    yuJson::Stats stats;
+    auto stats_json = Json::Parse(R"({"a": [1, 2.5, "long enough to leave the small string buffer"], "b": {"c": [[null]]}})", &stats);
+    stats_json.Print(false, &stats);
+    stats.ForEach([](const char* name, uint64_t value) {
+        if (value != 0 && std::string(name).find("_ns") == std::string::npos) {
+            std::cout << name << ": " << value << std::endl;
+        }
+    });
+    std::cout << std::endl;
+
+    /*
+    * memory resource
+    */
+    yuJson::MonotonicResource pool;
+    {
+        yuJson::MemoryResourceScope scope(&pool);
+        auto pooled = Json::Parse(R"({"key": ["a string that does not fit the small string buffer", 1, 2, 3]})");
+        pooled["key"].push_back("pushed");
+        std::cout << pooled.Print(false) << std::endl;
+    }
+    std::cout << (pool.Allocated() > 0 ? "allocated from pool" : "pool unused") << std::endl << std::endl;
+
+    /*
+    * exception-free parse and accessors
+    */
+    auto parse_result = Json::TryParse(R"({"a": [1, 2,, 3]})");
+    if (!parse_result) {
+        std::cout << yuJson::ParseErrorString(parse_result.error) << " at " << parse_result.offset << std::endl;
+    }
+    parse_result = Json::TryParse(R"({"a": [1, 2.5, "3"]})");
+    std::cout << parse_result.json.TryGet("/a/0")->TryInt().value_or(-1) << std::endl;
+    std::cout << parse_result.json.TryGet("/a/2")->TryInt().value_or(-1) << std::endl;
+    std::cout << (parse_result.json.TryGet("/b") ? "exist" : "non-existent") << std::endl << std::endl;
+
+    /*
+    * depth limit
+    */
+    yuJson::ParseOptions depth_options;
+    depth_options.max_depth = 64;
+    auto deep_result = Json::TryParse(std::string(100000, '[') + std::string(100000, ']'), depth_options);
+    std::cout << yuJson::ParseErrorString(deep_result.error) << " at " << deep_result.offset << std::endl;
+    deep_result = Json::TryParse(std::string(64, '[') + std::string(64, ']'), depth_options);
+    std::cout << (deep_result ? "accepted" : "rejected") << std::endl;
+    deep_result = Json::TryParse(std::string(4096, '[') + std::string(4096, ']'));
+    std::cout << (deep_result ? "accepted" : "rejected") << " without a limit" << std::endl << std::endl;
+
+    /*
+    * deep documents print and free without recursion
+    */
+    depth_options.max_depth = 1000000;
+    {
+        auto deep = Json::Parse(std::string(1000000, '[') + std::string(1000000, ']'), depth_options);
+        std::cout << deep.Print(false).size() << " " << deep.PrintParallel(false, 4).size() << std::endl;
+        auto deep_copy = Json::Parse(std::string(1000000, '[') + std::string(1000000, ']'), depth_options);
+        std::cout << (deep == deep_copy) << " " << Json::Diff(Json::Parse("null"), deep).Print(false).size() << std::endl;
+    }
+    {
+        std::string nested;
+        for (int i = 0; i < 100000; i++) {
+            nested += "{\"a\": ";
+        }
+        auto nested_a = Json::Parse(nested + "1" + std::string(100000, '}'));
+        auto nested_b = Json::Parse(nested + "2" + std::string(100000, '}'));
+        std::cout << (nested_a == nested_b) << " " << Json::Diff(nested_a, nested_b).size() << " ";
+        nested_a.ApplyMergePatch(std::move(nested_b));
+        std::cout << (nested_a == Json::Parse(nested + "2" + std::string(100000, '}'))) << std::endl << std::endl;
+    }
+
+    /*
+    * deferred destruction
+    */
+    yuJson::DeferredReclaimer deferred;
+    auto released = Json::Parse(R"({"a": [1, 2, 3], "b": {"c": null}})");
+    released.ReleaseAsync(&deferred);
+    std::cout << (released.IsValid() ? "valid" : "released") << ", pending " << deferred.Pending() << std::endl;
+    deferred.Drain();
+    std::cout << "pending " << deferred.Pending() << std::endl;
+    released = Json::Parse(std::string(100000, '[') + std::string(100000, ']'), depth_options);
+    released.ReleaseAsync();
+    yuJson::DefaultReclaimer()->Flush();
+    std::cout << "flushed" << std::endl << std::endl;
+
+    /*
+    * const, random access and member iterators
+    */
+    const Json iter_json = Json::Parse(R"({"b": [3, 1, 2], "a": {"x": true}})");
+    for (auto iter = iter_json.cbegin(); iter != iter_json.cend(); ++iter) {
+        std::cout << iter->key() << " ";
+    }
+    std::cout << std::endl;
+    auto elements = iter_json.find("b")->value().Elements();
+    std::cout << elements.size() << " " << elements[2].Print(false) << " " << (elements.end() - elements.begin()) << std::endl;
+    for (auto iter = elements.end(); iter != elements.begin();) {
+        std::cout << (--iter)->Print(false) << " ";
+    }
+    std::cout << std::endl;
+    for (auto member : iter_json.find("a")->value().Members()) {
+        std::cout << member.key << ":" << member.value.Print(false) << std::endl;
+    }
+    std::cout << std::endl;
+
+    /*
+    * builder
+    */
+    Json built = Json::Object();
+    auto& users = built.emplace("users", Json::Array());
+    users.reserve(3);
+    for (int i = 0; i < 3; i++) {
+        auto& user = users.emplace_back(Json::Object());
+        user.emplace("id", i);
+        user.emplace("name", std::string("user") + std::to_string(i));
+    }
+    Json tags = Json::Array({ "a", "b" });
+    built.emplace("tags", std::move(tags));
+    std::cout << built.Print(false) << " " << users.capacity() << std::endl;
+    Json point = Json::Array({ 1, 2 });
+    Json shape = { "points", { std::move(point), { 3, 4 } }, "name", std::string("line") };
+    std::cout << shape.Print(false) << " " << (point.IsValid() ? "copied" : "moved") << std::endl << std::endl;
+
+    /*
+    * key lookup without temporary strings
+    */
+    static constexpr yuJson::Key kName("name");
+    static_assert(kName.Hash() == yuJson::Key::Hash("name", 4), "key hash is computed at compile time");
+    std::string long_key = "a key long enough to not fit the small string buffer";
+    built[long_key] = true;
+    std::cout << users[1][kName].Print(false) << " " << (built.find(long_key) != built.end() ? "exist" : "non-existent") << std::endl;
+    std::cout << built.erase(yuJson::StringView(long_key.data(), 5)) << built.erase(long_key) << std::endl << std::endl;
+
+    /*
+    * lazy numbers
+    */
+    yuJson::ParseOptions lazy_options;
+    lazy_options.lazy_numbers = true;
+    auto lazy = Json::Parse(R"([18446744073709551615, -42, 0.1000000000000000055511151231257827, 99999999999999999999])", lazy_options);
+    std::cout << lazy.Print(false) << std::endl;
+    std::cout << lazy[0].Uint64() << " " << lazy[1].Int() << " " << lazy[2].RawNumber().size() << " " << lazy[3].RawNumber() << std::endl;
+#ifndef YUJSON_DISABLE_FLOAT
+    std::cout << lazy[2].Float() << std::endl;
+#endif
+    lazy[1] = 7;
+    std::cout << lazy.Print(false) << std::endl;
+    auto huge = Json::Parse(R"([18446744073709551614, -42, 0.1000000000000000055511151231257827, 99999999999999999999])", lazy_options);
+    std::cout << (lazy[0] == huge[0]) << (lazy[3] == huge[3]) << " " << Json::Diff(lazy, huge).Print(false) << std::endl << std::endl;
+
+    /*
+    * lazy strings
+    */
+    yuJson::ParseOptions lazy_string_options;
+    lazy_string_options.lazy_strings = true;
+    lazy = Json::Parse(R"({"k\u0065y": ["http://a/b", "tab\there \ud83d\ude00", "\u12"]})", lazy_string_options);
+    std::cout << (lazy.IsValid() ? "valid" : "invalid") << std::endl;
+    lazy = Json::Parse(R"({"k\u0065y": ["http://a/b", "tab\there \ud83d\ude00"]})", lazy_string_options);
+    std::cout << lazy.Print(false) << std::endl;
+    std::cout << lazy["key"][1].String() << std::endl;
+    std::cout << lazy.Print(false) << std::endl;
+    lazy = Json::Parse(R"(["a\\nb", "\u0001"])", lazy_string_options);
+    std::cout << lazy[0].String().size() << " " << lazy.Print(false) << std::endl;
+    std::cout << Json::Parse(R"(["a\\nb", "\u0001"])").Print(false) << std::endl << std::endl;
+
+    /*
+    * UTF-8 validation
+    */
+    yuJson::ParseOptions utf8_options;
+    utf8_options.validate_utf8 = true;
+    std::string utf8_text = "[\"" + std::string(40, 'a') + "\xe3\x81\x82\xf0\x9f\x98\x80\", \"\xe3\x81\"]";
+    parse_result = Json::TryParse(utf8_text, utf8_options);
+    std::cout << yuJson::ParseErrorString(parse_result.error) << " at " << parse_result.offset << std::endl;
+    std::cout << (Json::Parse(utf8_text).IsValid() ? "accepted" : "rejected") << " without validation" << std::endl << std::endl;
+
+    /*
+    * memory usage and shrink to fit
+    */
+    Json grown = Json::Parse(R"({"name": "a string that does not fit the small string buffer", "list": []})");
+    for (int i = 0; i < 100; i++) {
+        grown["list"].push_back(i);
+    }
+    auto usage = grown.MemoryUsage();
+    std::cout << usage.values << " values, slack " << (usage.slack > 0 ? "> 0" : "0") << std::endl;
+    grown.ShrinkToFit();
+    auto shrunk = grown.MemoryUsage();
+    std::cout << "slack " << shrunk.slack << ", saved " << usage.Total() - shrunk.Total() << " bytes" << std::endl << std::endl;
+
+    /*
+    * frozen documents
+    */
+    Json config = Json::Parse(R"({"name": "yuJson", "list": [1, 2.5, true, null, {"deep": ["x"]}], "empty": {}})");
+    config["map"] = Json::Object();
+    for (int i = 0; i < 20; i++) {
+        config["map"]["key" + std::to_string(i)] = i;
+    }
+    auto frozen = config.Freeze();
+    auto root = frozen.Root();
+    std::cout << root["name"].String().ToString() << " " << root["list"].size() << " " << root["list"][4]["deep"][0].String().ToString() << std::endl;
+    static constexpr yuJson::Key kKey13("key13");
+    std::cout << root["map"][kKey13].Int() << " " << root["map"].size() << " " << root["map"].KeyAt(0).ToString() << std::endl;
+    std::cout << (root["missing"].IsValid() ? "exist" : "non-existent") << " " << (root["list"][9].IsValid() ? "exist" : "non-existent")
+        << " " << root["empty"].size() << std::endl << std::endl;
+
+    /*
+    * pipelined reader
+    */
+    std::string stream_text = R"({"name": "a string longer than the chunk", "list": [true, false, null, 12345], "nested": {"k": "v"}, "many": [)";
+    for (int i = 0; i < 10000; i++) {
+        stream_text += (i ? ", \"item" : "\"item") + std::to_string(i) + "\"";
+    }
+    stream_text += "]}";
+    std::istringstream stream(stream_text);
+    yuJson::PipelinedReader reader(stream, 7);
+    Json streamed = Json::Parse(&reader);
+    std::cout << (streamed.Print(false) == Json::Parse(stream_text).Print(false) ? "same" : "different") << std::endl;
+    std::istringstream bad_stream(R"([1, 2, [3, tru]])");
+    yuJson::PipelinedReader bad_reader(bad_stream, 3);
+    parse_result = Json::TryParse(&bad_reader);
+    std::cout << yuJson::ParseErrorString(parse_result.error) << " at " << parse_result.offset << std::endl << std::endl;
+
+    /*
+    * parser context
+    */
+    yuJson::ParserContext context(yuJson::ParseOptions{}, true);
+    for (int i = 0; i < 3; i++) {
+        {
+            Json message = context.Parse(R"({"id": )" + std::to_string(i) + R"(, "tags": ["a", "b"], "body": {"text": "hello"}})");
+            std::cout << message.Print(false) << " ";
+        }
+        context.Reset();
+    }
+    parse_result = context.TryParse("[1, 2,]");
+    std::cout << std::endl << yuJson::ParseErrorString(parse_result.error) << " at " << parse_result.offset << std::endl;
+    std::cout << context.Parse("[true]").Print(false) << std::endl << std::endl;
+
+    /*
+    * JSONPath
+    */
+    Json shop = Json::Parse(R"({"orders": [{"id": 1, "total": 50, "tags": ["a"]}, {"id": 2, "total": 150}, {"id": 3, "total": 120, "tags": ["b", "c"]}]})");
+    auto expensive = yuJson::JsonPath::Compile("$.orders[?(@.total > 100 && @.id != 3)].id");
+    for (auto id : shop.Select(expensive)) {
+        std::cout << id->Int() << " ";
+    }
+    for (auto tag : shop.Select(yuJson::JsonPath::Compile("$..tags[-1]"))) {
+        std::cout << tag->String() << " ";
+    }
+    std::cout << shop.Select(yuJson::JsonPath::Compile("$.orders[::2].*")).size() << std::endl;
+    Json small = Json::Parse("[1, 2, 3]");
+    std::cout << small.Select(yuJson::JsonPath::Compile("$[1::9223372036854775807]")).size() << " "
+        << small.Select(yuJson::JsonPath::Compile("$[1::-9223372036854775807]")).size() << " "
+        << small.Select(yuJson::JsonPath::Compile("$[::-1]")).size() << std::endl;
+    auto bad_path = yuJson::JsonPath::Compile("$.orders[?(@.total >)]");
+    std::cout << (bad_path.IsValid() ? "valid" : "invalid") << " at " << bad_path.ErrorOffset() << std::endl << std::endl;
+
+    /*
+    * columnar extraction
+    */
+    auto table = yuJson::ColumnarTable::Parse(R"([{"ts": 1, "v": 2, "tag": "a"}, {"ts": 2, "v": 3, "tag": null}, {"ts": 3, "v": [0], "tag": "c", "extra": true}])");
+    for (auto& column : table.Columns()) {
+        std::cout << column.name << ":" << column.null_count;
+        for (size_t row = 0; row < table.Rows(); row++) {
+            std::cout << " " << (column.IsValid(row) ? "" : "!");
+            if (column.type == yuJson::ColumnType::kInt) std::cout << column.ints[row];
+            if (column.type == yuJson::ColumnType::kString) std::cout << column.StringAt(row).ToString();
+            if (column.type == yuJson::ColumnType::kBoolean) std::cout << int(column.booleans[row]);
+        }
+        std::cout << std::endl;
+    }
+#ifndef YUJSON_DISABLE_FLOAT
+    auto columns = Json::Parse(R"([{"x": 1}, {"x": 2.5}])").ToColumns();
+    std::cout << (columns.Find("x")->type == yuJson::ColumnType::kFloat ? "float" : "not float") << " " << columns.Find("x")->floats[0] << std::endl;
+#endif
+    std::cout << (Json::Parse("{}").ToColumns().IsValid() ? "valid" : "invalid") << " ";
+    yuJson::ParseError columns_error;
+    yuJson::ColumnarTable::Parse("[{\"a\": 1},]", &columns_error);
+    std::cout << yuJson::ParseErrorString(columns_error) << std::endl << std::endl;
+
+    /*
+    * JSON Schema
+    */
+    auto user_schema = yuJson::JsonSchema::Compile(R"({"type": "object", "required": ["id", "name"], "additionalProperties": false,
+        "properties": {"id": {"type": "integer", "minimum": 1}, "name": {"type": "string", "minLength": 2}, "tags": {"type": "array", "items": {"enum": ["a", "b"]}}}})");
+    yuJson::SchemaError schema_error;
+    std::cout << user_schema.ValidateText(R"({"id": 1, "name": "yu", "tags": ["a"]})") << " ";
+    user_schema.ValidateText(R"({"id": 1, "name": "yu", "tags": ["a", "c"]})", &schema_error);
+    std::cout << schema_error.message << " " << schema_error.path << " at " << schema_error.offset << std::endl;
+    Json user = Json::Parse(R"({"id": 0, "name": "yu"})");
+    user.Validate(user_schema, &schema_error);
+    std::cout << schema_error.message << " " << schema_error.path << std::endl;
+    user_schema.ValidateText(R"({"id": 1})", &schema_error);
+    std::cout << schema_error.message << " " << schema_error.path << std::endl;
+    auto bad_schema = yuJson::JsonSchema::Compile(R"({"properties": {"x": {"type": "text"}}})");
+    std::cout << (bad_schema.IsValid() ? "valid" : "invalid") << " at " << bad_schema.ErrorPath() << std::endl;
+    // the pattern matcher does not backtrack, a long string neither overflows the stack nor takes exponential time
+    auto pattern_schema = yuJson::JsonSchema::Compile(R"({"pattern": "((a|b)*)*c"})");
+    std::string long_string = "\"" + std::string(200000, 'a') + "\"";
+    std::cout << pattern_schema.ValidateText(long_string, &schema_error) << " " << schema_error.message << " ";
+    std::cout << pattern_schema.ValidateText("\"" + std::string(200000, 'b') + "c\"") << " ";
+    std::cout << yuJson::JsonSchema::Compile(R"({"pattern": "(?=a)b"})").IsValid() << std::endl;
+    // a repeated key counts once, in text as in the parsed document
+    auto max_one = yuJson::JsonSchema::Compile(R"({"maxProperties": 1})");
+    std::cout << max_one.ValidateText(R"({"a": 1, "a": 2})") << Json::Parse(R"({"a": 1, "a": 2})").Validate(max_one) << " ";
+    std::cout << max_one.ValidateText(R"({"a": 1, "b": 2})") << std::endl << std::endl;
+
+    /*
+    * stream transformer
+    */
+    yuJson::StreamTransformer redactor;
+    redactor.Drop("/**/password");
+    redactor.Replace("/token", R"("***")");
+    redactor.Rename("/user/name", "login");
+    redactor.On("/items/*", [](yuJson::FieldEdit* edit) {
+        if (edit->Raw() == "2") {
+            edit->Drop();
+        }
+    });
+    std::string redacted;
+    redactor.Transform("{\"user\": {\"name\": \"yu\", \"password\": \"x\"}, \"token\": [1, {\"a\": 2}], \"items\": [1, 2, 3]}\n{\"password\": 1}\n", &redacted);
+    std::cout << redacted;
+    redacted.clear();
+    yuJson::StreamTransformer overflow_redactor;
+    overflow_redactor.Drop("/18446744073709551616");
+    overflow_redactor.Transform("[1, 2]", &redacted);
+    std::cout << redacted << std::endl;
+    redacted.clear();
+    std::cout << redactor.Transform("{\"items\": [1,]}", &redacted) << " " << yuJson::ParseErrorString(redactor.Error()) << " at " << redactor.ErrorOffset() << std::endl << std::endl;
+
+    /*
+    * minify and prettify
+    */
+    std::string loose = "{ \"a\" : [ 1 , 10e2 , { } , \"x \\\" y\" ] ,\n\t\"b\": null }";
+    std::string tight;
+    yuJson::Minify(loose, &tight);
+    std::cout << tight << std::endl;
+    std::string pretty_text;
+    yuJson::Prettify(tight, &pretty_text, 2);
+    std::cout << pretty_text << std::endl;
+    yuJson::MinifyInPlace(&loose);
+    std::cout << (loose == tight ? "same" : "different") << " " << yuJson::Minify("[\"open", &tight) << std::endl << std::endl;
 }